@@ -0,0 +1,42 @@
+
+#ifndef __CH32V00x_ADCINJ_H
+#define __CH32V00x_ADCINJ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* ADCINJ Init structure definition */
+typedef struct {
+    const uint8_t *ADCINJ_Channels; /* Specifies the injected channels in conversion order.
+                                       Each entry can be a value of @ref ADC_channels */
+
+    uint8_t ADCINJ_ChannelCount; /* Specifies the number of entries in ADCINJ_Channels, 1 to 4. */
+
+    uint8_t ADCINJ_SampleTime; /* Specifies the sample time of every injected channel.
+                                  This parameter can be a value of @ref ADC_sampling_time */
+
+    const uint16_t *ADCINJ_Offsets; /* Specifies the offset subtracted in hardware from each
+                                       channel, e.g. the zero-current reading; 0 for none. */
+
+    uint32_t ADCINJ_Trigger; /* Specifies the TIM1 compare that starts the conversions:
+                                ADC_ExternalTrigInjecConv_T1_CC3 or ADC_ExternalTrigInjecConv_T1_CC4. */
+
+    void (*ADCINJ_Callback)(const int16_t *Results); /* Called from the JEOC interrupt with one
+                                 signed result per channel. Should be __HIGH_CODE as well. */
+} ADCINJ_InitTypeDef;
+
+void ADCINJ_Init(ADCINJ_InitTypeDef *ADCINJ_InitStruct);
+void ADCINJ_StructInit(ADCINJ_InitTypeDef *ADCINJ_InitStruct);
+void ADCINJ_Cmd(FunctionalState NewState);
+void ADCINJ_SetSamplePoint(uint16_t Compare);
+void ADCINJ_SetOffset(uint8_t Rank, uint16_t Offset);
+void ADCINJ_IRQHandler(void) __HIGH_CODE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_ADCINJ_H */
@@ -0,0 +1,59 @@
+
+#ifndef __CH32V00x_ADCMON_H
+#define __CH32V00x_ADCMON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* ADCMON supervised channel definition */
+typedef struct ADCMON_Channel {
+    uint8_t ADCMON_Channel; /* Specifies the ADC channel.
+                               This parameter can be a value of @ref ADC_channels */
+
+    uint16_t ADCMON_High; /* Specifies the upper limit, a reading above it is an event. */
+
+    uint16_t ADCMON_Low; /* Specifies the lower limit, a reading below it is an event. */
+
+    uint16_t ADCMON_Hysteresis; /* Specifies how far back inside a limit a reading must come
+                                   to end the event. */
+
+    void (*ADCMON_Callback)(struct ADCMON_Channel *Channel); /* Called from interrupt context on
+                                   every state change, 0 if unused. */
+
+    volatile uint8_t ADCMON_State; /* Set by the monitor, a value of @ref ADCMON_state. */
+
+    volatile uint16_t ADCMON_Value; /* Set by the monitor: the reading that changed the state. */
+
+    volatile uint32_t ADCMON_Timestamp; /* Set by the monitor: SysTick->CNT at the state change. */
+} ADCMON_ChannelTypeDef;
+
+/* ADCMON Init structure definition */
+typedef struct {
+    ADCMON_ChannelTypeDef *ADCMON_Channels; /* Specifies the supervised channels. */
+
+    uint8_t ADCMON_ChannelCount; /* Specifies the number of entries in ADCMON_Channels. */
+
+    uint8_t ADCMON_SampleTime; /* Specifies the sample time of every channel.
+                                  This parameter can be a value of @ref ADC_sampling_time */
+} ADCMON_InitTypeDef;
+
+/* ADCMON_state */
+#define ADCMON_State_Normal                  ((uint8_t)0x00)
+#define ADCMON_State_High                    ((uint8_t)0x01)
+#define ADCMON_State_Low                     ((uint8_t)0x02)
+
+void ADCMON_Init(ADCMON_InitTypeDef *ADCMON_InitStruct);
+void ADCMON_StructInit(ADCMON_InitTypeDef *ADCMON_InitStruct);
+void ADCMON_Start(void);
+void ADCMON_Stop(void);
+void ADCMON_Tick(void);
+void ADCMON_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_ADCMON_H */
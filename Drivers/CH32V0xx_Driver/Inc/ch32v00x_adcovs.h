@@ -0,0 +1,40 @@
+
+#ifndef __CH32V00x_ADCOVS_H
+#define __CH32V00x_ADCOVS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Highest number of channels per scan */
+#define ADCOVS_MaxChannels                   10
+
+/* ADCOVS Init structure definition */
+typedef struct {
+    uint8_t ADCOVS_ChannelCount; /* Specifies the number of channels in each ADCSCAN scan. */
+
+    uint8_t ADCOVS_ExtraBits; /* Specifies the bits added to the 10-bit readings, 1 to 4:
+                                 each result sums 4^ADCOVS_ExtraBits scans. */
+
+    uint16_t ADCOVS_BlockScans; /* Specifies the ADCSCAN_BlockScans of the ring. */
+
+    uint16_t ADCOVS_DitherMask; /* Specifies the range of the random trigger delay in ADC clocks
+                                   as a power of two minus one, at most 0x1FF; 0 for no dither.
+                                   Needs ADCOVS_BlockScans of at most 4^ADCOVS_ExtraBits / 4,
+                                   otherwise dither stays off. */
+
+    void (*ADCOVS_Callback)(const uint16_t *Results); /* Called from interrupt context with one
+                                 result of 10 + ADCOVS_ExtraBits bits per channel. */
+} ADCOVS_InitTypeDef;
+
+void ADCOVS_Init(ADCOVS_InitTypeDef *ADCOVS_InitStruct);
+void ADCOVS_StructInit(ADCOVS_InitTypeDef *ADCOVS_InitStruct);
+void ADCOVS_Process(uint16_t *Block, uint16_t Scans);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_ADCOVS_H */
@@ -0,0 +1,51 @@
+
+#ifndef __CH32V00x_ADCSCAN_H
+#define __CH32V00x_ADCSCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* ADCSCAN Init structure definition */
+typedef struct {
+    const uint8_t *ADCSCAN_Channels; /* Specifies the channels in scan order.
+                                        Each entry can be a value of @ref ADC_channels */
+
+    uint8_t ADCSCAN_ChannelCount; /* Specifies the number of entries in ADCSCAN_Channels, 1 to 10. */
+
+    uint8_t ADCSCAN_SampleTime; /* Specifies the sample time of every channel.
+                                   This parameter can be a value of @ref ADC_sampling_time */
+
+    uint16_t *ADCSCAN_Buffer; /* Specifies the DMA ring, two blocks of ADCSCAN_BlockScans scans. */
+
+    uint16_t ADCSCAN_BlockScans; /* Specifies the number of scans in one block. */
+
+    uint32_t ADCSCAN_Trigger; /* Specifies what starts each scan: ADC_ExternalTrigConv_None runs
+                                 back to back, ADC_ExternalTrigConv_T1_TRGO or _T2_TRGO once per
+                                 timer update. */
+
+    uint32_t ADCSCAN_Rate; /* Specifies the scan rate in Hz with a timer trigger. 0 leaves the
+                              timer to the application, e.g. to sample on its PWM period. */
+
+    uint16_t ADCSCAN_TriggerDelay; /* Specifies the ADC clock cycles from the trigger to the start
+                                      of the scan, 0 to 0x1FF. */
+
+    void (*ADCSCAN_Callback)(uint16_t *Block, uint16_t Scans); /* Called from interrupt context with
+                                   each filled block, samples interleaved in scan order. */
+} ADCSCAN_InitTypeDef;
+
+void     ADCSCAN_Init(ADCSCAN_InitTypeDef *ADCSCAN_InitStruct);
+void     ADCSCAN_StructInit(ADCSCAN_InitTypeDef *ADCSCAN_InitStruct);
+uint32_t ADCSCAN_SetRate(uint32_t Rate);
+void     ADCSCAN_Start(void);
+void     ADCSCAN_Stop(void);
+uint16_t ADCSCAN_GetOverruns(void);
+void     ADCSCAN_DMA_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_ADCSCAN_H */
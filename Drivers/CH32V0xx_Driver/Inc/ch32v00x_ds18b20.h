@@ -0,0 +1,43 @@
+
+#ifndef __CH32V00x_DS18B20_H
+#define __CH32V00x_DS18B20_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* DS18B20 ROM family code */
+#define DS18B20_FamilyCode                   ((uint8_t)0x28)
+
+/* DS18B20_function_commands */
+#define DS18B20_CMD_ConvertT                 ((uint8_t)0x44)
+#define DS18B20_CMD_WriteScratchpad          ((uint8_t)0x4E)
+#define DS18B20_CMD_ReadScratchpad           ((uint8_t)0xBE)
+#define DS18B20_CMD_CopyScratchpad           ((uint8_t)0x48)
+#define DS18B20_CMD_RecallE2                 ((uint8_t)0xB8)
+#define DS18B20_CMD_ReadPowerSupply          ((uint8_t)0xB4)
+
+/* DS18B20_resolution */
+#define DS18B20_Resolution_9b                ((uint8_t)0x1F)
+#define DS18B20_Resolution_10b               ((uint8_t)0x3F)
+#define DS18B20_Resolution_11b               ((uint8_t)0x5F)
+#define DS18B20_Resolution_12b               ((uint8_t)0x7F)
+
+/* Scratchpad length including its CRC byte */
+#define DS18B20_ScratchpadSize               ((uint8_t)9)
+
+ErrorStatus DS18B20_StartConversion(const uint8_t *Rom);
+FlagStatus  DS18B20_GetConversionStatus(void);
+uint16_t    DS18B20_GetConversionTime(uint8_t Resolution);
+ErrorStatus DS18B20_ReadScratchpad(const uint8_t *Rom, uint8_t *Scratchpad);
+ErrorStatus DS18B20_ReadTemperature(const uint8_t *Rom, int16_t *Temperature);
+ErrorStatus DS18B20_SetResolution(const uint8_t *Rom, uint8_t Resolution);
+int16_t     DS18B20_ToCentiCelsius(int16_t Temperature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_DS18B20_H */
@@ -0,0 +1,91 @@
+
+#ifndef __CH32V00x_FILTER_H
+#define __CH32V00x_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Signed power-of-two terms per biquad coefficient */
+#ifndef FILTER_CSDTerms
+#define FILTER_CSDTerms                      3
+#endif
+
+/* Highest CIC order */
+#ifndef FILTER_CICMaxOrder
+#define FILTER_CICMaxOrder                   3
+#endif
+
+/* Fractional bits of the biquad state */
+#define FILTER_BiquadFrac                    8
+
+/* FILTER moving average definition */
+typedef struct {
+    uint16_t *FILTER_History; /* Specifies the sample history, 1 << FILTER_Log2Length entries. */
+
+    uint8_t FILTER_Log2Length; /* Specifies the window length as a power of two. */
+
+    uint16_t FILTER_Index; /* Position in the history, owned by the filter. */
+
+    uint32_t FILTER_Sum; /* Sum of the window, owned by the filter. */
+} FILTER_MATypeDef;
+
+/* FILTER exponential smoother definition */
+typedef struct {
+    uint8_t FILTER_Shift; /* Specifies the smoothing factor as 2^-FILTER_Shift. */
+
+    int32_t FILTER_Accumulator; /* Output times 2^FILTER_Shift, owned by the filter. */
+} FILTER_EMATypeDef;
+
+/* FILTER CIC decimator definition */
+typedef struct {
+    uint8_t FILTER_Order; /* Specifies the number of integrator/comb stages, 1 to FILTER_CICMaxOrder. */
+
+    uint8_t FILTER_Log2Rate; /* Specifies the decimation rate as a power of two. The gain,
+                                FILTER_Order * FILTER_Log2Rate bits, must fit 32 bits with the input. */
+
+    uint16_t FILTER_Phase; /* Inputs since the last output, owned by the filter. */
+
+    uint32_t FILTER_Integrator[FILTER_CICMaxOrder]; /* Owned by the filter. */
+
+    uint32_t FILTER_Comb[FILTER_CICMaxOrder]; /* Owned by the filter. */
+} FILTER_CICTypeDef;
+
+/* FILTER coefficient as signed power-of-two terms (canonical signed digit) */
+typedef struct {
+    uint8_t FILTER_Terms; /* Number of terms used. */
+
+    uint8_t FILTER_Negative; /* Bit i set when term i is subtracted. */
+
+    uint8_t FILTER_Shift[FILTER_CSDTerms]; /* Term i weighs 2^(1 - FILTER_Shift[i]). */
+} FILTER_CSDTypeDef;
+
+/* FILTER biquad definition, direct form I */
+typedef struct {
+    FILTER_CSDTypeDef FILTER_B[3]; /* Feed-forward coefficients, set by FILTER_BiquadInit(). */
+
+    FILTER_CSDTypeDef FILTER_A[2]; /* Feedback coefficients a1 and a2, set by FILTER_BiquadInit(). */
+
+    int32_t FILTER_X[2]; /* Past inputs, owned by the filter. */
+
+    int32_t FILTER_Y[2]; /* Past outputs, owned by the filter. */
+} FILTER_BiquadTypeDef;
+
+void     FILTER_MAInit(FILTER_MATypeDef *Filter, uint16_t *History, uint8_t Log2Length);
+void     FILTER_MAProcess(FILTER_MATypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out);
+void     FILTER_EMAInit(FILTER_EMATypeDef *Filter, uint8_t Shift, uint16_t Initial);
+void     FILTER_EMAProcess(FILTER_EMATypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out);
+void     FILTER_CICInit(FILTER_CICTypeDef *Filter, uint8_t Order, uint8_t Log2Rate);
+uint16_t FILTER_CICProcess(FILTER_CICTypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out);
+void     FILTER_CSDQuantize(FILTER_CSDTypeDef *Coefficient, int16_t Value);
+int32_t  FILTER_CSDValue(const FILTER_CSDTypeDef *Coefficient);
+void     FILTER_BiquadInit(FILTER_BiquadTypeDef *Filter, const int16_t *Coefficients);
+void     FILTER_BiquadProcess(FILTER_BiquadTypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, int16_t *Out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_FILTER_H */
@@ -0,0 +1,61 @@
+
+#ifndef __CH32V00x_FRAME_H
+#define __CH32V00x_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* FRAME Init structure definition */
+typedef struct {
+    uint8_t FRAME_Encoding; /* Specifies the byte stuffing used on the wire.
+                               This parameter can be a value of @ref FRAME_encoding */
+
+    uint8_t *FRAME_RxBuffer; /* Specifies the buffer the decoder writes the payload into.
+                                Bytes are stored once, already unstuffed, including the two CRC bytes. */
+
+    uint16_t FRAME_RxBufferSize; /* Specifies the size of FRAME_RxBuffer in bytes.
+                                    The largest payload accepted is FRAME_RxBufferSize - 2. */
+
+    void (*FRAME_RxCallback)(uint8_t *Data, uint16_t Length); /* Called from FRAME_IRQHandler() when a frame
+                                                                 with a valid CRC has been received.
+                                                                 Data points into FRAME_RxBuffer and is only valid
+                                                                 until the callback returns. */
+} FRAME_InitTypeDef;
+
+/* FRAME_encoding */
+#define FRAME_Encoding_COBS                  ((uint8_t)0x00)
+#define FRAME_Encoding_SLIP                  ((uint8_t)0x01)
+
+/* FRAME_events */
+#define FRAME_EVENT_NONE                     ((uint8_t)0x00) /* Byte consumed, frame still in progress */
+#define FRAME_EVENT_FRAME                    ((uint8_t)0x01) /* Complete frame with valid CRC in FRAME_RxBuffer */
+#define FRAME_EVENT_ERROR                    ((uint8_t)0x02) /* Frame dropped: CRC, stuffing or length error */
+
+/* SLIP special characters */
+#define FRAME_SLIP_END                       ((uint8_t)0xC0)
+#define FRAME_SLIP_ESC                       ((uint8_t)0xDB)
+#define FRAME_SLIP_ESC_END                   ((uint8_t)0xDC)
+#define FRAME_SLIP_ESC_ESC                   ((uint8_t)0xDD)
+
+/* CRC-16/CCITT-FALSE initial value */
+#define FRAME_CRC16_INIT                     ((uint16_t)0xFFFF)
+
+void       FRAME_Init(FRAME_InitTypeDef *FRAME_InitStruct);
+void       FRAME_StructInit(FRAME_InitTypeDef *FRAME_InitStruct);
+void       FRAME_Reset(void);
+uint8_t    FRAME_RxByte(uint8_t Data);
+uint16_t   FRAME_GetRxLength(void);
+ErrorStatus FRAME_Send(const uint8_t *Data, uint16_t Length);
+FlagStatus FRAME_GetTxBusy(void);
+uint16_t   FRAME_GetErrorCount(void);
+uint16_t   FRAME_CRC16Update(uint16_t Crc, uint8_t Data);
+void       FRAME_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_FRAME_H */
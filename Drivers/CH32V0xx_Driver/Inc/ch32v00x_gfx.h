@@ -0,0 +1,83 @@
+
+#ifndef __CH32V00x_GFX_H
+#define __CH32V00x_GFX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* GFX Init structure definition */
+typedef struct {
+    uint8_t GFX_Controller; /* Specifies the display controller.
+                               This parameter can be a value of @ref GFX_controller */
+
+    uint16_t GFX_Width; /* Specifies the width in pixels, a multiple of GFX_TileWidth. */
+
+    uint16_t GFX_Height; /* Specifies the height in pixels, a multiple of GFX_TileHeight. */
+
+    uint8_t GFX_XOffset; /* Specifies the column of the panel origin in controller RAM. */
+
+    uint8_t GFX_YOffset; /* Specifies the row of the panel origin in controller RAM. */
+
+    GPIO_TypeDef *GFX_CSPort; /* Specifies the GPIO port of the chip select pin. */
+
+    uint16_t GFX_CSPin; /* Specifies the chip select pin. */
+
+    GPIO_TypeDef *GFX_DCPort; /* Specifies the GPIO port of the data/command pin. */
+
+    uint16_t GFX_DCPin; /* Specifies the data/command pin. */
+
+    uint16_t GFX_BaudRatePrescaler; /* Specifies the SPI1 clock prescaler for the display.
+                                       This parameter can be a value of @ref SPI_BaudRate_Prescaler */
+
+    uint16_t GFX_Background; /* Specifies the colour each tile is cleared to before drawing. */
+
+    void (*GFX_DrawCallback)(void); /* Draws the whole scene with the GFX_Draw* functions.
+                                       Called once per dirty tile, drawing is clipped to it. */
+} GFX_InitTypeDef;
+
+/* GFX_controller */
+#define GFX_Controller_SSD1306               ((uint8_t)0x00)
+#define GFX_Controller_ST7735                ((uint8_t)0x01)
+
+/* Tile geometry: one SSD1306 page high, 256 bytes of RGB565 */
+#define GFX_TileWidth                        16
+#define GFX_TileHeight                       8
+
+/* Largest supported panel */
+#define GFX_MaxWidth                         160
+#define GFX_MaxHeight                        160
+
+/* Font cell, 5x7 glyphs with one column and one row of spacing */
+#define GFX_FontWidth                        6
+#define GFX_FontHeight                       8
+
+/* RGB565 colour from 8-bit components */
+#define GFX_RGB(R, G, B)                     ((uint16_t)((((R) & 0xF8) << 8) | (((G) & 0xFC) << 3) | ((B) >> 3)))
+
+/* Monochrome colours */
+#define GFX_Black                            ((uint16_t)0x0000)
+#define GFX_White                            ((uint16_t)0xFFFF)
+
+void GFX_Init(GFX_InitTypeDef *GFX_InitStruct);
+void GFX_StructInit(GFX_InitTypeDef *GFX_InitStruct);
+void GFX_WriteCommand(uint8_t Command, const uint8_t *Params, uint8_t Length);
+void GFX_Invalidate(int16_t X, int16_t Y, int16_t Width, int16_t Height);
+void GFX_InvalidateAll(void);
+void GFX_Render(void);
+void GFX_Wait(void);
+void GFX_DrawPixel(int16_t X, int16_t Y, uint16_t Colour);
+void GFX_FillRect(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint16_t Colour);
+void GFX_DrawRect(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint16_t Colour);
+void GFX_DrawLine(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, uint16_t Colour);
+void GFX_DrawBitmap(int16_t X, int16_t Y, int16_t Width, int16_t Height, const uint8_t *Bitmap, uint16_t Colour);
+void GFX_DrawChar(int16_t X, int16_t Y, char Char, uint16_t Colour);
+void GFX_DrawString(int16_t X, int16_t Y, const char *String, uint16_t Colour);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_GFX_H */
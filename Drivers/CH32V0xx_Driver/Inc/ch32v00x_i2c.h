@@ -11,13 +11,15 @@ extern "C" {
 /* I2C Init structure definition  */
 typedef struct {
     uint32_t I2C_ClockSpeed; /* Specifies the clock frequency.
-                                This parameter must be set to a value lower than 400kHz */
+                                This parameter must be set to a value up to 1MHz; the closest
+                                rate not above it is chosen from the current PCLK */
 
     uint16_t I2C_Mode; /* Specifies the I2C mode.
                           This parameter can be a value of @ref I2C_mode */
 
     uint16_t I2C_DutyCycle; /* Specifies the I2C fast mode duty cycle.
-                               This parameter can be a value of @ref I2C_duty_cycle_in_fast_mode */
+                               This parameter can be a value of @ref I2C_duty_cycle_in_fast_mode,
+                               I2C_DutyCycle_Auto picks the one closest to I2C_ClockSpeed */
 
     uint16_t I2C_OwnAddress1; /* Specifies the first device own address.
                                  This parameter can be a 7-bit or 10-bit address. */
@@ -29,12 +31,28 @@ typedef struct {
                                          This parameter can be a value of @ref I2C_acknowledged_address */
 } I2C_InitTypeDef;
 
+/* I2C timing report */
+typedef struct {
+    uint32_t I2C_ClockSpeed; /* Achieved SCL frequency in Hz with ideal edges. */
+
+    uint32_t I2C_LowTime; /* SCL low period in ns. */
+
+    uint32_t I2C_HighTime; /* SCL high period in ns. */
+
+    uint16_t I2C_RiseTime; /* Rise time budget in ns allowed by the selected speed mode.
+                              The high period is counted once SCL is seen high, so each ns
+                              of rise lengthens the SCL period. */
+
+    uint32_t I2C_SlowestClockSpeed; /* SCL frequency in Hz when SCL rises in exactly I2C_RiseTime. */
+} I2C_TimingTypeDef;
+
 /* I2C_mode */
 #define I2C_Mode_I2C                                         ((uint16_t)0x0000)
 
 /* I2C_duty_cycle_in_fast_mode */
 #define I2C_DutyCycle_16_9                                   ((uint16_t)0x4000) /* I2C fast mode Tlow/Thigh = 16/9 */
 #define I2C_DutyCycle_2                                      ((uint16_t)0xBFFF) /* I2C fast mode Tlow/Thigh = 2 */
+#define I2C_DutyCycle_Auto                                   ((uint16_t)0x0000) /* I2C fast mode duty chosen by I2C_Init */
 
 /* I2C_acknowledgement */
 #define I2C_Ack_Enable                                       ((uint16_t)0x0400)
@@ -267,6 +285,8 @@ uint8_t  I2C_GetPEC(I2C_TypeDef *I2Cx);
 void     I2C_ARPCmd(I2C_TypeDef *I2Cx, FunctionalState NewState);
 void     I2C_StretchClockCmd(I2C_TypeDef *I2Cx, FunctionalState NewState);
 void     I2C_FastModeDutyCycleConfig(I2C_TypeDef *I2Cx, uint16_t I2C_DutyCycle);
+void     I2C_GetTiming(I2C_TypeDef *I2Cx, I2C_TimingTypeDef *I2C_Timing);
+void     I2C_ClockUpdate(I2C_TypeDef *I2Cx);
 
 /**
  *                         I2C State Monitoring Functions
@@ -0,0 +1,96 @@
+
+#ifndef __CH32V00x_I2CM_H
+#define __CH32V00x_I2CM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Transfers of at least this many bytes in one direction use DMA, 2 or more */
+#ifndef I2CM_DMAThreshold
+#define I2CM_DMAThreshold                    4
+#endif
+
+/* I2CM_Tick() periods allowed per transfer, plus one per 8 bytes */
+#ifndef I2CM_TimeoutTicks
+#define I2CM_TimeoutTicks                    10
+#endif
+
+/* I2CM transfer definition */
+typedef struct I2CM_Transfer {
+    uint8_t I2CM_Address; /* Specifies the 7-bit slave address, not shifted. */
+
+    const uint8_t *I2CM_TxData; /* Specifies the bytes to write first. */
+
+    uint16_t I2CM_TxLength; /* Specifies the number of bytes to write, 0 for a plain read. */
+
+    uint8_t *I2CM_RxData; /* Specifies where read bytes go. */
+
+    uint16_t I2CM_RxLength; /* Specifies the number of bytes to read after a repeated START,
+                               0 for a plain write. Both lengths 0 probe the address.
+                               Includes the PEC byte with I2CM_Flag_PEC. With I2CM_Flag_Block
+                               it is the buffer size. */
+
+    uint8_t I2CM_Flags; /* Specifies transfer options.
+                           This parameter can be any combination of @ref I2CM_flags */
+
+    uint16_t I2CM_Received; /* Set by the engine: bytes placed in I2CM_RxData, the count byte
+                               and PEC included. Below I2CM_RxLength only for a block read. */
+
+    volatile uint8_t I2CM_Status; /* Set by the engine, a value of @ref I2CM_status. */
+
+    void (*I2CM_Callback)(struct I2CM_Transfer *Transfer); /* Called from interrupt context
+                                                              on completion, 0 if unused. */
+} I2CM_TransferTypeDef;
+
+/* I2CM_flags */
+#define I2CM_Flag_None                       ((uint8_t)0x00)
+#define I2CM_Flag_PEC                        ((uint8_t)0x01) /* Hardware PEC on the last byte */
+#define I2CM_Flag_Block                      ((uint8_t)0x02) /* First byte read is the count of data bytes */
+
+/* I2CM error counters, saturating */
+typedef struct {
+    uint16_t I2CM_BusError; /* BERR: misplaced START or STOP. */
+
+    uint16_t I2CM_ArbitrationLost; /* ARLO: another master won the bus. */
+
+    uint16_t I2CM_AckFailure; /* AF: address or data not acknowledged. */
+
+    uint16_t I2CM_Overrun; /* OVR: data register overrun or underrun. */
+
+    uint16_t I2CM_PECError; /* PECERR: received PEC mismatch. */
+
+    uint16_t I2CM_Timeout; /* Transfers aborted by a timeout. */
+
+    uint16_t I2CM_Recovery; /* Bus recoveries performed. */
+} I2CM_ErrorsTypeDef;
+
+/* I2CM_status */
+#define I2CM_Status_Idle                     ((uint8_t)0x00)
+#define I2CM_Status_Busy                     ((uint8_t)0x01)
+#define I2CM_Status_Done                     ((uint8_t)0x02)
+#define I2CM_Status_Nack                     ((uint8_t)0x03)
+#define I2CM_Status_Error                    ((uint8_t)0x04)
+#define I2CM_Status_Timeout                  ((uint8_t)0x05)
+#define I2CM_Status_PECError                 ((uint8_t)0x06)
+
+void        I2CM_Init(void);
+ErrorStatus I2CM_Submit(I2CM_TransferTypeDef *Transfer);
+uint8_t     I2CM_Transfer(I2CM_TransferTypeDef *Transfer);
+FlagStatus  I2CM_GetBusy(void);
+void        I2CM_EV_IRQHandler(void);
+void        I2CM_ER_IRQHandler(void);
+void        I2CM_DMA_IRQHandler(void);
+void        I2CM_Tick(void);
+void        I2CM_RecoveryConfig(GPIO_TypeDef *GPIOx, uint16_t SCLPin, uint16_t SDAPin);
+ErrorStatus I2CM_Recover(void);
+void        I2CM_GetErrors(I2CM_ErrorsTypeDef *Errors);
+void        I2CM_ClearErrors(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_I2CM_H */
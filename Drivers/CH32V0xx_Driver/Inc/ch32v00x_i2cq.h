@@ -0,0 +1,43 @@
+
+#ifndef __CH32V00x_I2CQ_H
+#define __CH32V00x_I2CQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+#include "ch32v00x_i2cm.h"
+
+/* I2CQ job definition */
+typedef struct I2CQ_Job {
+    I2CM_TransferTypeDef I2CQ_Transfer; /* Specifies address and buffers. I2CM_Callback is owned by
+                                           the scheduler, I2CM_Status holds the last result. */
+
+    uint8_t I2CQ_Priority; /* Specifies the priority among due jobs, 0 is the highest. */
+
+    uint16_t I2CQ_Period; /* Specifies the poll period in I2CQ_Tick() calls, 0 for a one-shot job. */
+
+    void (*I2CQ_Callback)(struct I2CQ_Job *Job); /* Called from interrupt context after each run,
+                                                    0 if unused. */
+
+    volatile uint16_t I2CQ_Overruns; /* Set by the scheduler: polls merged into one still waiting. */
+
+    uint16_t I2CQ_Countdown; /* Ticks to the next poll, owned by the scheduler. */
+
+    volatile uint8_t I2CQ_Pending; /* Waiting to run, owned by the scheduler. */
+
+    struct I2CQ_Job *I2CQ_Next; /* List link, owned by the scheduler. */
+} I2CQ_JobTypeDef;
+
+void        I2CQ_Init(void);
+ErrorStatus I2CQ_Add(I2CQ_JobTypeDef *Job);
+void        I2CQ_Remove(I2CQ_JobTypeDef *Job);
+void        I2CQ_Tick(void);
+FlagStatus  I2CQ_GetBusy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_I2CQ_H */
@@ -0,0 +1,67 @@
+
+#ifndef __CH32V00x_I2CSLV_H
+#define __CH32V00x_I2CSLV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* I2CSLV register definition, one entry of a const register map */
+typedef struct I2CSLV_Register {
+    uint8_t I2CSLV_Address; /* Specifies the first register address of the block. */
+
+    uint8_t I2CSLV_Size; /* Specifies the number of byte registers in the block. */
+
+    uint8_t I2CSLV_Access; /* Specifies what the master may do.
+                              This parameter can be a value of @ref I2CSLV_access */
+
+    uint8_t *I2CSLV_Data; /* Specifies the backing storage, I2CSLV_Size bytes. */
+
+    void (*I2CSLV_Callback)(const struct I2CSLV_Register *Register, uint8_t Event); /* Called once the
+                              transaction has ended with a value of @ref I2CSLV_event, 0 if unused. */
+} I2CSLV_RegisterTypeDef;
+
+/* I2CSLV Init structure definition */
+typedef struct {
+    uint8_t I2CSLV_Address1; /* Specifies the primary 7-bit slave address. */
+
+    const I2CSLV_RegisterTypeDef *I2CSLV_Map1; /* Specifies the register map behind the primary address. */
+
+    uint8_t I2CSLV_Map1Size; /* Specifies the number of entries in I2CSLV_Map1, at most 32;
+                                further entries are ignored. */
+
+    uint8_t I2CSLV_Address2; /* Specifies the second 7-bit slave address, 0 if unused. */
+
+    const I2CSLV_RegisterTypeDef *I2CSLV_Map2; /* Specifies the register map behind the second address. */
+
+    uint8_t I2CSLV_Map2Size; /* Specifies the number of entries in I2CSLV_Map2, at most 32;
+                                further entries are ignored. */
+
+    FunctionalState I2CSLV_Stretch; /* Specifies whether the slave may stretch SCL while its
+                                       interrupt is pending. */
+} I2CSLV_InitTypeDef;
+
+/* I2CSLV_access */
+#define I2CSLV_Access_Read                   ((uint8_t)0x01)
+#define I2CSLV_Access_Write                  ((uint8_t)0x02)
+#define I2CSLV_Access_ReadWrite              ((uint8_t)0x03)
+
+/* I2CSLV_event */
+#define I2CSLV_Event_Read                    ((uint8_t)0x01)
+#define I2CSLV_Event_Write                   ((uint8_t)0x02)
+
+/* Byte returned for unmapped or write-only registers */
+#define I2CSLV_FillByte                      ((uint8_t)0xFF)
+
+void I2CSLV_Init(I2CSLV_InitTypeDef *I2CSLV_InitStruct);
+void I2CSLV_StructInit(I2CSLV_InitTypeDef *I2CSLV_InitStruct);
+void I2CSLV_EV_IRQHandler(void);
+void I2CSLV_ER_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_I2CSLV_H */
@@ -0,0 +1,51 @@
+
+#ifndef __CH32V00x_IAP_H
+#define __CH32V00x_IAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* IAP Init structure definition */
+typedef struct {
+    uint32_t IAP_BaudRate; /* Specifies the USART1 baud rate of the download link. */
+
+    uint32_t IAP_Address; /* Specifies the flash address the image is written to.
+                             Must be 64-byte aligned and inside the user area. An image
+                             overlapping the running program is refused, so the default
+                             FLASH_BASE only suits a loader started from the boot area
+                             (FLASH_STATR boot mode set). */
+
+    uint16_t IAP_Timeout; /* Specifies how long to wait for the header and for each page, in milliseconds. */
+} IAP_InitTypeDef;
+
+/* IAP_status */
+#define IAP_Status_OK                        ((uint8_t)0x00)
+#define IAP_Status_Timeout                   ((uint8_t)0x01)
+#define IAP_Status_HeaderError               ((uint8_t)0x02)
+#define IAP_Status_VerifyError               ((uint8_t)0x03)
+#define IAP_Status_CRCError                  ((uint8_t)0x04)
+#define IAP_Status_AddressError              ((uint8_t)0x05)
+
+/* Link protocol bytes */
+#define IAP_Sync0                            ((uint8_t)0x49)
+#define IAP_Sync1                            ((uint8_t)0x41)
+#define IAP_ACK                              ((uint8_t)0x79)
+#define IAP_NAK                              ((uint8_t)0x1F)
+
+/* Fast programming page size */
+#define IAP_PageSize                         ((uint16_t)64)
+
+void    IAP_Init(IAP_InitTypeDef *IAP_InitStruct);
+void    IAP_StructInit(IAP_InitTypeDef *IAP_InitStruct);
+uint8_t IAP_Download(void);
+void    IAP_JumpToUser(void);
+void    IAP_JumpToBoot(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_IAP_H */
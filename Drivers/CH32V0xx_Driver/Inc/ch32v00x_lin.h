@@ -0,0 +1,86 @@
+
+#ifndef __CH32V00x_LIN_H
+#define __CH32V00x_LIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* LIN frame table entry definition */
+typedef struct {
+    uint8_t LIN_Id; /* Specifies the frame identifier, 0 to 63 (without parity bits). */
+
+    uint8_t LIN_Direction; /* Specifies whether this node publishes or subscribes to the response.
+                              This parameter can be a value of @ref LIN_direction */
+
+    uint8_t LIN_Length; /* Specifies the number of response data bytes, 1 to 8. */
+
+    uint8_t LIN_Checksum; /* Specifies the checksum model.
+                             This parameter can be a value of @ref LIN_checksum_model */
+
+    void (*LIN_Handler)(uint8_t Id, uint8_t *Data, uint8_t Length); /* Called from interrupt context.
+                                                                       Publish: fills Data before transmission.
+                                                                       Subscribe: receives Data once the
+                                                                       checksum has been verified. */
+} LIN_FrameTypeDef;
+
+/* LIN Init structure definition */
+typedef struct {
+    uint32_t LIN_BaudRate; /* Specifies the nominal bit rate, 1000 to 20000 bit/s. */
+
+    FunctionalState LIN_AutoBaud; /* Specifies whether the bit rate is re-measured on every sync field.
+                                     Requires the RX pin on an EXTI line and TIM2 running free. */
+
+    uint8_t LIN_RxPortSource; /* Specifies the GPIO port of the RX pin, a value of @ref GPIO_Port_Sources.
+                                 Used for auto-baud and wake-up detection. */
+
+    uint8_t LIN_RxPinSource; /* Specifies the RX pin number, a value of @ref GPIO_Pin_sources. */
+
+    const LIN_FrameTypeDef *LIN_FrameTable; /* Points to the const frame table. */
+
+    uint8_t LIN_FrameTableSize; /* Specifies the number of entries in LIN_FrameTable. */
+
+    void (*LIN_SleepCallback)(void); /* Called from interrupt context when the bus goes to sleep, 0 if unused. */
+} LIN_InitTypeDef;
+
+/* LIN_direction */
+#define LIN_Direction_Subscribe              ((uint8_t)0x00)
+#define LIN_Direction_Publish                ((uint8_t)0x01)
+
+/* LIN_checksum_model */
+#define LIN_Checksum_Classic                 ((uint8_t)0x00)
+#define LIN_Checksum_Enhanced                ((uint8_t)0x01)
+
+/* LIN_status */
+#define LIN_Status_Active                    ((uint8_t)0x00)
+#define LIN_Status_Sleep                     ((uint8_t)0x01)
+
+/* LIN diagnostic frame identifiers */
+#define LIN_Id_MasterRequest                 ((uint8_t)0x3C)
+#define LIN_Id_SlaveResponse                 ((uint8_t)0x3D)
+
+/* LIN sync field value */
+#define LIN_SyncByte                         ((uint8_t)0x55)
+
+/* Bus inactivity before going to sleep, in LIN_Tick() periods */
+#define LIN_BusIdleTimeout                   ((uint16_t)4000)
+
+void     LIN_Init(LIN_InitTypeDef *LIN_InitStruct);
+void     LIN_StructInit(LIN_InitTypeDef *LIN_InitStruct);
+uint8_t  LIN_ProtectedId(uint8_t Id);
+uint8_t  LIN_GetStatus(void);
+uint16_t LIN_GetErrorCount(void);
+void     LIN_GotoSleep(void);
+void     LIN_SendWakeup(void);
+void     LIN_Idle(void);
+void     LIN_Tick(void);
+void     LIN_USART_IRQHandler(void);
+void     LIN_EXTI_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_LIN_H */
@@ -0,0 +1,48 @@
+
+#ifndef __CH32V00x_LOG_H
+#define __CH32V00x_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Ring size in 32-bit words, must be a power of two */
+#ifndef LOG_RingWords
+#define LOG_RingWords                        64
+#endif
+
+/* Maximum number of argument words per record */
+#define LOG_MaxArgs                          8
+
+/* Record header: [31:24] sync, [23:20] sequence, [19:16] argument count, [15:0] format id */
+#define LOG_HeaderSync                       ((uint32_t)0xA5000000)
+
+/**
+ * @brief   Logs a message without formatting it on the target.
+ *          The format string is placed in the non-loaded .log_fmt section
+ *        and only its offset plus up to LOG_MaxArgs integer arguments are
+ *        stored, one 32-bit word each. Formatting is done on the host from
+ *        the ELF file. Safe to use from interrupt handlers.
+ */
+#define LOG(Format, ...)                                                            \
+    do {                                                                            \
+        static const char LOG_Fmt[] __attribute__((section(".log_fmt"), used)) = Format; \
+        LOG_Write((uint32_t)LOG_Fmt, LOG_NARGS(__VA_ARGS__),                        \
+                  (const uint32_t[]){0, ##__VA_ARGS__} + 1);                        \
+    } while(0)
+
+#define LOG_NARGS(...)                       LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+void     LOG_Write(uint32_t Id, uint8_t Count, const uint32_t *Args);
+uint16_t LOG_Read(uint8_t *Data, uint16_t Size);
+void     LOG_Process(void);
+uint16_t LOG_GetDropCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_LOG_H */
@@ -0,0 +1,83 @@
+
+#ifndef __CH32V00x_MDBUS_H
+#define __CH32V00x_MDBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Largest polled node table, 1 to 255; each node takes 2 bytes of RAM */
+#ifndef MDBUS_MaxNodes
+#define MDBUS_MaxNodes                       32
+#endif
+
+/* MDBUS polled node definition (master only) */
+typedef struct {
+    uint8_t MDBUS_Address; /* Specifies the slave address, 1 to 254. */
+
+    uint16_t MDBUS_Period; /* Specifies the poll period in MDBUS_Tick() periods. */
+
+    uint8_t (*MDBUS_Request)(uint8_t Address, uint8_t *Data); /* Fills the request payload and returns its length. */
+
+    void (*MDBUS_Response)(uint8_t Address, uint8_t *Data, uint8_t Length,
+                           uint8_t Status); /* Receives the reply payload, or a failure status.
+                                               Status can be a value of @ref MDBUS_status */
+} MDBUS_NodeTypeDef;
+
+/* MDBUS Init structure definition */
+typedef struct {
+    uint8_t MDBUS_Role; /* Specifies whether this node is the bus master or a slave.
+                           This parameter can be a value of @ref MDBUS_role */
+
+    uint32_t MDBUS_BaudRate; /* Specifies the USART1 baud rate. Frames use 9 data bits. */
+
+    uint8_t MDBUS_Address; /* Specifies the slave own address, 1 to 254. The low nibble is
+                              matched in hardware, the full byte in software. */
+
+    uint8_t *MDBUS_Buffer; /* Specifies the payload buffer shared by requests and replies. */
+
+    uint16_t MDBUS_BufferSize; /* Specifies the size of MDBUS_Buffer, at most 255 bytes are used. */
+
+    GPIO_TypeDef *MDBUS_DEPort; /* Specifies the GPIO port of the RS-485 driver enable pin, 0 if unused. */
+
+    uint16_t MDBUS_DEPin; /* Specifies the RS-485 driver enable pin. */
+
+    uint8_t (*MDBUS_RequestCallback)(uint8_t *Data, uint8_t Length); /* Slave: called from interrupt context
+                                                                        with a request addressed to this node.
+                                                                        The reply is built in place in Data and
+                                                                        its length returned. */
+
+    const MDBUS_NodeTypeDef *MDBUS_Nodes; /* Master: points to the const table of polled slaves. */
+
+    uint8_t MDBUS_NodeCount; /* Master: specifies the number of entries in MDBUS_Nodes, at most
+                                MDBUS_MaxNodes; further entries are never polled. */
+
+    uint16_t MDBUS_Timeout; /* Master: specifies the reply timeout in MDBUS_Tick() periods. */
+} MDBUS_InitTypeDef;
+
+/* MDBUS_role */
+#define MDBUS_Role_Slave                     ((uint8_t)0x00)
+#define MDBUS_Role_Master                    ((uint8_t)0x01)
+
+/* MDBUS_status */
+#define MDBUS_Status_OK                      ((uint8_t)0x00)
+#define MDBUS_Status_Timeout                 ((uint8_t)0x01)
+#define MDBUS_Status_Error                   ((uint8_t)0x02)
+
+/* Address mark: the 9th data bit flags the first byte of a request */
+#define MDBUS_AddressMark                    ((uint16_t)0x0100)
+
+void     MDBUS_Init(MDBUS_InitTypeDef *MDBUS_InitStruct);
+void     MDBUS_StructInit(MDBUS_InitTypeDef *MDBUS_InitStruct);
+void     MDBUS_MasterProcess(void);
+void     MDBUS_Tick(void);
+uint16_t MDBUS_GetErrorCount(void);
+void     MDBUS_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_MDBUS_H */
@@ -0,0 +1,92 @@
+
+#ifndef __CH32V00x_MODBUS_H
+#define __CH32V00x_MODBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* MODBUS register map region definition */
+typedef struct {
+    uint8_t MODBUS_Type; /* Specifies the object type held by the region.
+                            This parameter can be a value of @ref MODBUS_object_type */
+
+    uint16_t MODBUS_Address; /* Specifies the protocol address of the first object in the region. */
+
+    uint16_t MODBUS_Count; /* Specifies the number of objects in the region. */
+
+    void *MODBUS_Data; /* Points to the backing storage of the region.
+                          Coils and discrete inputs are packed 8 per byte, LSB first (uint8_t[]).
+                          Holding and input registers are stored as uint16_t[]. */
+} MODBUS_RegionTypeDef;
+
+/* MODBUS Init structure definition */
+typedef struct {
+    uint32_t MODBUS_BaudRate; /* Specifies the USART1 baud rate. The T1.5/T3.5 gaps are derived from it. */
+
+    uint16_t MODBUS_Parity; /* Specifies the parity mode.
+                               This parameter can be a value of @ref USART_Parity */
+
+    uint8_t MODBUS_SlaveAddress; /* Specifies the slave address, 1 to 247. */
+
+    const MODBUS_RegionTypeDef *MODBUS_Map; /* Points to the const register map table. */
+
+    uint8_t MODBUS_MapSize; /* Specifies the number of entries in MODBUS_Map. */
+
+    uint8_t *MODBUS_Buffer; /* Specifies the ADU buffer shared by request and reply.
+                               256 bytes covers every request, smaller buffers limit the quantities. */
+
+    uint16_t MODBUS_BufferSize; /* Specifies the size of MODBUS_Buffer in bytes. */
+
+    GPIO_TypeDef *MODBUS_DEPort; /* Specifies the GPIO port of the RS-485 driver enable pin, 0 if unused. */
+
+    uint16_t MODBUS_DEPin; /* Specifies the RS-485 driver enable pin. */
+
+    void (*MODBUS_WriteCallback)(const MODBUS_RegionTypeDef *Region, uint16_t Address,
+                                 uint16_t Count); /* Called from interrupt context after the master
+                                                     has written Count objects starting at Address,
+                                                     0 if unused. */
+} MODBUS_InitTypeDef;
+
+/* MODBUS_object_type */
+#define MODBUS_Type_Coil                     ((uint8_t)0x00)
+#define MODBUS_Type_DiscreteInput            ((uint8_t)0x01)
+#define MODBUS_Type_HoldingRegister          ((uint8_t)0x02)
+#define MODBUS_Type_InputRegister            ((uint8_t)0x03)
+
+/* MODBUS_function_codes */
+#define MODBUS_FC_ReadCoils                  ((uint8_t)0x01)
+#define MODBUS_FC_ReadDiscreteInputs         ((uint8_t)0x02)
+#define MODBUS_FC_ReadHoldingRegisters       ((uint8_t)0x03)
+#define MODBUS_FC_ReadInputRegisters         ((uint8_t)0x04)
+#define MODBUS_FC_WriteSingleCoil            ((uint8_t)0x05)
+#define MODBUS_FC_WriteSingleRegister        ((uint8_t)0x06)
+#define MODBUS_FC_WriteMultipleCoils         ((uint8_t)0x0F)
+#define MODBUS_FC_WriteMultipleRegisters     ((uint8_t)0x10)
+#define MODBUS_FC_ReadWriteMultipleRegisters ((uint8_t)0x17)
+
+/* MODBUS_exception_codes */
+#define MODBUS_EX_IllegalFunction            ((uint8_t)0x01)
+#define MODBUS_EX_IllegalDataAddress         ((uint8_t)0x02)
+#define MODBUS_EX_IllegalDataValue           ((uint8_t)0x03)
+
+/* MODBUS broadcast address */
+#define MODBUS_BroadcastAddress              ((uint8_t)0x00)
+
+/* CRC-16/MODBUS initial value */
+#define MODBUS_CRC16_INIT                    ((uint16_t)0xFFFF)
+
+void     MODBUS_Init(MODBUS_InitTypeDef *MODBUS_InitStruct);
+void     MODBUS_StructInit(MODBUS_InitTypeDef *MODBUS_InitStruct);
+uint16_t MODBUS_CRC16Update(uint16_t Crc, uint8_t Data);
+uint16_t MODBUS_GetErrorCount(void);
+void     MODBUS_USART_IRQHandler(void);
+void     MODBUS_TIM_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_MODBUS_H */
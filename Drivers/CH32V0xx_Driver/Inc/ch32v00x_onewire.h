@@ -0,0 +1,43 @@
+
+#ifndef __CH32V00x_ONEWIRE_H
+#define __CH32V00x_ONEWIRE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* OW_ROM_commands */
+#define OW_CMD_SearchRom                     ((uint8_t)0xF0)
+#define OW_CMD_ReadRom                       ((uint8_t)0x33)
+#define OW_CMD_MatchRom                      ((uint8_t)0x55)
+#define OW_CMD_SkipRom                       ((uint8_t)0xCC)
+#define OW_CMD_AlarmSearch                   ((uint8_t)0xEC)
+
+/* Length of a ROM code: family, 48-bit serial number, CRC-8 */
+#define OW_RomSize                           ((uint8_t)8)
+
+/* CRC-8/MAXIM initial value */
+#define OW_CRC8_INIT                         ((uint8_t)0x00)
+
+void        OW_Init(void);
+FlagStatus  OW_Reset(void);
+uint8_t     OW_TouchBit(uint8_t Bit);
+uint8_t     OW_TouchByte(uint8_t Data);
+void        OW_WriteByte(uint8_t Data);
+uint8_t     OW_ReadByte(void);
+void        OW_Write(const uint8_t *Data, uint16_t Length);
+void        OW_Read(uint8_t *Data, uint16_t Length);
+ErrorStatus OW_Select(const uint8_t *Rom);
+void        OW_SearchReset(void);
+ErrorStatus OW_Search(uint8_t *Rom, uint8_t Command);
+uint8_t     OW_CRC8Update(uint8_t Crc, uint8_t Data);
+uint8_t     OW_CRC8(const uint8_t *Data, uint16_t Length);
+uint16_t    OW_GetErrorCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_ONEWIRE_H */
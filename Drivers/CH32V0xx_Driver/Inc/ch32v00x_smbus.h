@@ -0,0 +1,62 @@
+
+#ifndef __CH32V00x_SMBUS_H
+#define __CH32V00x_SMBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* SMBUS Init structure definition */
+typedef struct {
+    uint8_t SMBUS_Type; /* Specifies the SMBus role of I2C1.
+                           This parameter can be a value of @ref SMBUS_type */
+
+    FunctionalState SMBUS_PEC; /* Specifies whether host transfers carry a PEC byte. */
+
+    FunctionalState SMBUS_ARP; /* Specifies whether ARP is enabled: a device then acknowledges
+                                  the SMBus device default address, a host its host address. */
+} SMBUS_InitTypeDef;
+
+/* SMBUS_type */
+#define SMBUS_Type_Device                    ((uint8_t)0x00)
+#define SMBUS_Type_Host                      ((uint8_t)0x01)
+
+/* Longest SMBus block */
+#define SMBUS_BlockMax                       32
+
+/* SMBus ARP, always with PEC */
+#define SMBUS_ARP_Address                    ((uint8_t)0x61)
+#define SMBUS_ARP_UDIDLength                 16
+#define SMBUS_ARP_CMD_Prepare                ((uint8_t)0x01)
+#define SMBUS_ARP_CMD_Reset                  ((uint8_t)0x02)
+#define SMBUS_ARP_CMD_GetUDID                ((uint8_t)0x03)
+#define SMBUS_ARP_CMD_Assign                 ((uint8_t)0x04)
+
+void     SMBUS_Init(SMBUS_InitTypeDef *SMBUS_InitStruct);
+void     SMBUS_StructInit(SMBUS_InitTypeDef *SMBUS_InitStruct);
+void     SMBUS_PECCmd(FunctionalState NewState);
+void     SMBUS_ARPCmd(FunctionalState NewState);
+uint8_t  SMBUS_GetPEC(void);
+uint8_t  SMBUS_SendByte(uint8_t Address, uint8_t Command);
+uint8_t  SMBUS_WriteByte(uint8_t Address, uint8_t Command, uint8_t Data);
+uint8_t  SMBUS_ReadByte(uint8_t Address, uint8_t Command, uint8_t *Data);
+uint8_t  SMBUS_WriteWord(uint8_t Address, uint8_t Command, uint16_t Data);
+uint8_t  SMBUS_ReadWord(uint8_t Address, uint8_t Command, uint16_t *Data);
+uint8_t  SMBUS_BlockWrite(uint8_t Address, uint8_t Command, const uint8_t *Data, uint8_t Length);
+uint8_t  SMBUS_BlockRead(uint8_t Address, uint8_t Command, uint8_t *Data, uint8_t *Length);
+uint8_t  SMBUS_ARPPrepare(void);
+uint8_t  SMBUS_ARPReset(void);
+uint8_t  SMBUS_ARPGetUDID(uint8_t *UDID, uint8_t *Address);
+uint8_t  SMBUS_ARPAssign(const uint8_t *UDID, uint8_t Address);
+int32_t  SMBUS_Linear11ToFixed(uint16_t Raw, uint8_t Frac);
+uint16_t SMBUS_FixedToLinear11(int32_t Value, uint8_t Frac);
+uint32_t SMBUS_Linear16ToFixed(uint16_t Raw, uint8_t Mode, uint8_t Frac);
+uint16_t SMBUS_FixedToLinear16(uint32_t Value, uint8_t Mode, uint8_t Frac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_SMBUS_H */
@@ -0,0 +1,75 @@
+
+#ifndef __CH32V00x_SPIBUS_H
+#define __CH32V00x_SPIBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+#include "ch32v00x_spi.h"
+
+/* SPIBUS device definition */
+typedef struct {
+    GPIO_TypeDef *SPIBUS_CSPort; /* Specifies the GPIO port of the chip select pin, 0 if unused. */
+
+    uint16_t SPIBUS_CSPin; /* Specifies the chip select pin, active low. */
+
+    uint16_t SPIBUS_CTLR1; /* Cached SPI1 CTLR1 value (mode, prescaler, data size),
+                              filled by SPIBUS_DeviceInit(). */
+} SPIBUS_DeviceTypeDef;
+
+/* SPIBUS transaction definition */
+typedef struct SPIBUS_Transaction {
+    SPIBUS_DeviceTypeDef *SPIBUS_Device; /* Specifies the device to talk to. */
+
+    const uint8_t *SPIBUS_TxData; /* Specifies the data to send, 0 to clock out SPIBUS_FillByte.
+                                     Must be half-word aligned with SPIBUS_Flag_16Bit. */
+
+    uint8_t *SPIBUS_RxData; /* Specifies where received data goes, 0 to discard it. */
+
+    uint16_t SPIBUS_Length; /* Specifies the number of frames to exchange, at least 1.
+                               Frames are bytes, or half-words with SPIBUS_Flag_16Bit. */
+
+    uint8_t SPIBUS_Flags; /* Specifies transaction options.
+                             This parameter can be any combination of @ref SPIBUS_flags */
+
+    volatile uint8_t SPIBUS_Status; /* Set by the engine, a value of @ref SPIBUS_status. */
+
+    void (*SPIBUS_Callback)(struct SPIBUS_Transaction *Transaction); /* Called from interrupt context
+                                                                        on completion, 0 if unused. */
+
+    struct SPIBUS_Transaction *SPIBUS_Next; /* Queue link, owned by the engine. */
+} SPIBUS_TransactionTypeDef;
+
+/* SPIBUS_flags */
+#define SPIBUS_Flag_None                     ((uint8_t)0x00)
+#define SPIBUS_Flag_HoldCS                   ((uint8_t)0x01)
+#define SPIBUS_Flag_16Bit                    ((uint8_t)0x02)
+#define SPIBUS_Flag_Fill                     ((uint8_t)0x04)
+
+/* SPIBUS_status */
+#define SPIBUS_Status_Idle                   ((uint8_t)0x00)
+#define SPIBUS_Status_Pending                ((uint8_t)0x01)
+#define SPIBUS_Status_Done                   ((uint8_t)0x02)
+
+/* Byte clocked out when a transaction has no TX data */
+#define SPIBUS_FillByte                      ((uint8_t)0xFF)
+
+void        SPIBUS_Init(void);
+void        SPIBUS_DeviceInit(SPIBUS_DeviceTypeDef *Device, SPI_InitTypeDef *SPI_InitStruct,
+                              GPIO_TypeDef *CSPort, uint16_t CSPin);
+ErrorStatus SPIBUS_Submit(SPIBUS_TransactionTypeDef *Transaction);
+ErrorStatus SPIBUS_Transfer(SPIBUS_TransactionTypeDef *Transaction);
+ErrorStatus SPIBUS_Write16(SPIBUS_TransactionTypeDef *Transaction, SPIBUS_DeviceTypeDef *Device,
+                           const uint16_t *Data, uint16_t Count, uint8_t Flags);
+ErrorStatus SPIBUS_Fill16(SPIBUS_TransactionTypeDef *Transaction, SPIBUS_DeviceTypeDef *Device,
+                          const uint16_t *Value, uint16_t Count, uint8_t Flags);
+FlagStatus  SPIBUS_GetBusy(void);
+void        SPIBUS_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_SPIBUS_H */
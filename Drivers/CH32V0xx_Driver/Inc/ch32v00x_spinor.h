@@ -0,0 +1,60 @@
+
+#ifndef __CH32V00x_SPINOR_H
+#define __CH32V00x_SPINOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Read cache geometry, both must be powers of two */
+#ifndef SPINOR_CacheLines
+#define SPINOR_CacheLines                    4
+#endif
+#ifndef SPINOR_CacheLineSize
+#define SPINOR_CacheLineSize                 32
+#endif
+
+/* SPINOR Init structure definition */
+typedef struct {
+    GPIO_TypeDef *SPINOR_CSPort; /* Specifies the GPIO port of the flash chip select pin. */
+
+    uint16_t SPINOR_CSPin; /* Specifies the flash chip select pin. */
+
+    uint16_t SPINOR_BaudRatePrescaler; /* Specifies the SPI1 clock prescaler for the flash.
+                                          This parameter can be a value of @ref SPI_BaudRate_Prescaler */
+} SPINOR_InitTypeDef;
+
+/* SPINOR_commands */
+#define SPINOR_CMD_WriteEnable               ((uint8_t)0x06)
+#define SPINOR_CMD_ReadStatus                ((uint8_t)0x05)
+#define SPINOR_CMD_FastRead                  ((uint8_t)0x0B)
+#define SPINOR_CMD_PageProgram               ((uint8_t)0x02)
+#define SPINOR_CMD_SectorErase               ((uint8_t)0x20)
+#define SPINOR_CMD_JedecId                   ((uint8_t)0x9F)
+#define SPINOR_CMD_ReleasePowerDown          ((uint8_t)0xAB)
+
+/* SPINOR status register bits */
+#define SPINOR_Status_WIP                    ((uint8_t)0x01)
+#define SPINOR_Status_WEL                    ((uint8_t)0x02)
+
+/* SPINOR geometry */
+#define SPINOR_PageSize                      ((uint16_t)256)
+#define SPINOR_SectorSize                    ((uint32_t)4096)
+
+void        SPINOR_Init(SPINOR_InitTypeDef *SPINOR_InitStruct);
+void        SPINOR_StructInit(SPINOR_InitTypeDef *SPINOR_InitStruct);
+uint32_t    SPINOR_ReadJedecId(void);
+uint32_t    SPINOR_GetSize(void);
+ErrorStatus SPINOR_WaitReady(void);
+ErrorStatus SPINOR_Read(uint32_t Address, uint8_t *Data, uint16_t Length);
+ErrorStatus SPINOR_Write(uint32_t Address, const uint8_t *Data, uint16_t Length);
+ErrorStatus SPINOR_EraseSector(uint32_t Address);
+void        SPINOR_InvalidateCache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_SPINOR_H */
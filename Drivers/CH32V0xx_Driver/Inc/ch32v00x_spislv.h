@@ -0,0 +1,56 @@
+
+#ifndef __CH32V00x_SPISLV_H
+#define __CH32V00x_SPISLV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ch32v00x.h"
+
+/* Receive ring size in bytes, a power of two */
+#ifndef SPISLV_RingSize
+#define SPISLV_RingSize                      256
+#endif
+
+/* Number of received frames that can wait for SPISLV_Receive(), a power of two */
+#ifndef SPISLV_MaxFrames
+#define SPISLV_MaxFrames                     8
+#endif
+
+/* SPISLV Init structure definition */
+typedef struct {
+    GPIO_TypeDef *SPISLV_NSSPort; /* Specifies the GPIO port of the slave select input. */
+
+    uint16_t SPISLV_NSSPin; /* Specifies the slave select pin, active low. */
+
+    uint16_t SPISLV_CPOL; /* Specifies the serial clock steady state.
+                             This parameter can be a value of @ref SPI_Clock_Polarity */
+
+    uint16_t SPISLV_CPHA; /* Specifies the clock active edge for the bit capture.
+                             This parameter can be a value of @ref SPI_Clock_Phase */
+
+    uint16_t SPISLV_CRCPolynomial; /* Specifies the CRC-8 polynomial used on both directions. */
+
+    void (*SPISLV_FrameCallback)(uint8_t Status); /* Called from SPISLV_NSSHandler() after each frame
+                                                     with a value of @ref SPISLV_status, 0 if unused. */
+} SPISLV_InitTypeDef;
+
+/* SPISLV_status */
+#define SPISLV_Status_None                   ((uint8_t)0x00)
+#define SPISLV_Status_OK                     ((uint8_t)0x01)
+#define SPISLV_Status_CRCError               ((uint8_t)0x02)
+#define SPISLV_Status_Overrun                ((uint8_t)0x03)
+
+void     SPISLV_Init(SPISLV_InitTypeDef *SPISLV_InitStruct);
+void     SPISLV_StructInit(SPISLV_InitTypeDef *SPISLV_InitStruct);
+void     SPISLV_SetResponse(const uint8_t *Data, uint16_t Length);
+uint8_t  SPISLV_Receive(uint8_t *Data, uint16_t *Length);
+uint16_t SPISLV_GetErrorCount(void);
+void     SPISLV_NSSHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CH32V00x_SPISLV_H */
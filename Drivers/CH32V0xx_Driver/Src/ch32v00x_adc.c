@@ -823,7 +823,7 @@ void ADC_Calibration_Vol(ADC_TypeDef *ADCx, uint32_t ADC_CALVOL) {
  * @return  none
  */
 void ADC_ExternalTrig_DLY(ADC_TypeDef *ADCx, uint32_t channel, uint16_t DelayTim) {
-    ADCx->DLYR &= ~(uint32_t)(0x2FF);
+    ADCx->DLYR &= ~(uint32_t)(0x3FF);
     ADCx->DLYR |= channel;
     ADCx->DLYR |= DelayTim;
 }
@@ -0,0 +1,148 @@
+#include "ch32v00x_adcinj.h"
+#include "ch32v00x_adc.h"
+#include "ch32v00x_tim.h"
+
+static uint8_t  ADCINJ_ChannelCount = 0;
+static uint8_t  ADCINJ_UseCC4 = 0;
+static int16_t  ADCINJ_Results[4];
+static void (*ADCINJ_Callback)(const int16_t *Results) = 0;
+
+/**
+ * @brief   Initializes the ADC1 injected group for conversions started by
+ *        a TIM1 compare, typically current sensing in a PWM loop. The
+ *        injected group interrupts regular conversions, so an ADCSCAN scan
+ *        keeps running in the background; call this after ADCSCAN_Init(),
+ *        which resets the ADC. Without it the ADC is powered up and
+ *        calibrated here.
+ *          The trigger compare channel is set up as a timing channel with
+ *        no output; ADCINJ_SetSamplePoint() places it in the PWM period.
+ *        The application owns the TIM1 time base and its PWM channels.
+ *          Offsets are subtracted by the ADC, so results arrive signed and
+ *        centred on the offset with no CPU work. The JEOC handler is
+ *        linked to RAM (__HIGH_CODE) to avoid flash wait states in the
+ *        control loop; ADC1_IRQHandler(), which calls
+ *        ADCINJ_IRQHandler(), should be __HIGH_CODE too.
+ *          Peripheral clocks, the analog pins and the ADC1 NVIC channel
+ *        are configured by the application.
+ * @param   ADCINJ_InitStruct - pointer to a ADCINJ_InitTypeDef structure.
+ * @return  none
+ */
+void ADCINJ_Init(ADCINJ_InitTypeDef *ADCINJ_InitStruct) {
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    uint8_t           i;
+
+    ADCINJ_ChannelCount = ADCINJ_InitStruct->ADCINJ_ChannelCount;
+    ADCINJ_Callback = ADCINJ_InitStruct->ADCINJ_Callback;
+    ADCINJ_UseCC4 = (ADCINJ_InitStruct->ADCINJ_Trigger == ADC_ExternalTrigInjecConv_T1_CC4);
+
+    if((ADC1->CTLR2 & ADC_ADON) == 0) {
+        ADC_Cmd(ADC1, ENABLE);
+        ADC_ResetCalibration(ADC1);
+        while(ADC_GetResetCalibrationStatus(ADC1))
+            ;
+        ADC_StartCalibration(ADC1);
+        while(ADC_GetCalibrationStatus(ADC1))
+            ;
+    }
+
+    /* The length goes first: it sets where each rank lands in ISQR */
+    ADC_InjectedSequencerLengthConfig(ADC1, ADCINJ_ChannelCount);
+    for(i = 0; i < ADCINJ_ChannelCount; i++) {
+        ADC_InjectedChannelConfig(ADC1, ADCINJ_InitStruct->ADCINJ_Channels[i], (uint8_t)(i + 1),
+                                  ADCINJ_InitStruct->ADCINJ_SampleTime);
+        ADCINJ_SetOffset((uint8_t)(i + 1),
+                         (ADCINJ_InitStruct->ADCINJ_Offsets != 0) ? ADCINJ_InitStruct->ADCINJ_Offsets[i] : 0);
+    }
+    if(ADCINJ_ChannelCount > 1) {
+        ADC1->CTLR1 |= ADC_SCAN;
+    }
+    ADC_ExternalTrigInjectedConvConfig(ADC1, ADCINJ_InitStruct->ADCINJ_Trigger);
+
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+    if(ADCINJ_UseCC4) {
+        TIM_OC4Init(TIM1, &TIM_OCInitStructure);
+        TIM_OC4PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    }
+    else {
+        TIM_OC3Init(TIM1, &TIM_OCInitStructure);
+        TIM_OC3PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    }
+}
+
+/**
+ * @brief   Fills each ADCINJ_InitStruct member with its default value.
+ * @param   ADCINJ_InitStruct - pointer to a ADCINJ_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void ADCINJ_StructInit(ADCINJ_InitTypeDef *ADCINJ_InitStruct) {
+    ADCINJ_InitStruct->ADCINJ_Channels = 0;
+    ADCINJ_InitStruct->ADCINJ_ChannelCount = 1;
+    ADCINJ_InitStruct->ADCINJ_SampleTime = ADC_SampleTime_9Cycles;
+    ADCINJ_InitStruct->ADCINJ_Offsets = 0;
+    ADCINJ_InitStruct->ADCINJ_Trigger = ADC_ExternalTrigInjecConv_T1_CC4;
+    ADCINJ_InitStruct->ADCINJ_Callback = 0;
+}
+
+/**
+ * @brief   Enables or disables the triggered injected conversions.
+ * @param   NewState - ENABLE or DISABLE.
+ * @return  none
+ */
+void ADCINJ_Cmd(FunctionalState NewState) {
+    ADC1->STATR = ~(uint32_t)ADC_JEOC;
+    ADC_ITConfig(ADC1, ADC_IT_JEOC, NewState);
+    ADC_ExternalTrigInjectedConvCmd(ADC1, NewState);
+}
+
+/**
+ * @brief   Places the sample point in the TIM1 period. With edge-aligned
+ *        PWM1, where a channel is on while the counter is below its
+ *        compare value, half that value samples the middle of the on-time,
+ *        away from both switching edges. The compare is preloaded, so a
+ *        new point applies from the next period, together with a new duty.
+ * @param   Compare - TIM1 counter value at which to sample.
+ * @return  none
+ */
+void ADCINJ_SetSamplePoint(uint16_t Compare) {
+    if(ADCINJ_UseCC4) {
+        TIM1->CH4CVR = Compare;
+    }
+    else {
+        TIM1->CH3CVR = Compare;
+    }
+}
+
+/**
+ * @brief   Sets the offset the ADC subtracts from one injected channel,
+ *        e.g. after measuring the zero-current reading at run time.
+ * @param   Rank - position of the channel in ADCINJ_Channels, from 1.
+ *          Offset - value subtracted, 0 to 0x3FF.
+ * @return  none
+ */
+void ADCINJ_SetOffset(uint8_t Rank, uint16_t Offset) {
+    ADC_SetInjectedOffset(ADC1, (uint8_t)(ADC_InjectedChannel_1 + ((Rank - 1) << 2)), Offset);
+}
+
+/**
+ * @brief   Collects the injected results and passes them to the callback.
+ *        Runs from RAM.
+ * @return  none
+ */
+void ADCINJ_IRQHandler(void) {
+    volatile uint32_t *data = &ADC1->IDATAR1;
+    uint8_t            i;
+
+    if((ADC1->STATR & ADC_JEOC) == 0) {
+        return;
+    }
+    ADC1->STATR = ~(uint32_t)ADC_JEOC;
+    for(i = 0; i < ADCINJ_ChannelCount; i++) {
+        ADCINJ_Results[i] = (int16_t)data[i];
+    }
+    if(ADCINJ_Callback != 0) {
+        ADCINJ_Callback(ADCINJ_Results);
+    }
+}
@@ -0,0 +1,184 @@
+#include "ch32v00x_adcmon.h"
+#include "ch32v00x_adc.h"
+
+/* Full scale of the 10-bit ADC */
+#define ADCMON_FullScale         ((uint16_t)0x03FF)
+
+static ADCMON_ChannelTypeDef *ADCMON_Channels = 0;
+static uint8_t                ADCMON_ChannelCount = 0;
+static uint8_t                ADCMON_SampleTime = 0;
+static uint8_t                ADCMON_Index = 0;
+
+/**
+ * @brief   Arms the watchdog for the current channel: it becomes the only
+ *        regular conversion and the watchdog window is set from its
+ *        state. In an event the window is the way back in, moved by the
+ *        hysteresis, so the watchdog stays silent until the event ends.
+ * @return  none
+ */
+static void ADCMON_Arm(void) {
+    ADCMON_ChannelTypeDef *channel = &ADCMON_Channels[ADCMON_Index];
+
+    if(channel->ADCMON_State == ADCMON_State_High) {
+        ADC1->WDHTR = ADCMON_FullScale;
+        ADC1->WDLTR = (channel->ADCMON_High > channel->ADCMON_Hysteresis) ?
+                          (uint16_t)(channel->ADCMON_High - channel->ADCMON_Hysteresis) :
+                          0;
+    }
+    else if(channel->ADCMON_State == ADCMON_State_Low) {
+        ADC1->WDHTR = ((uint32_t)channel->ADCMON_Low + channel->ADCMON_Hysteresis < ADCMON_FullScale) ?
+                          (uint16_t)(channel->ADCMON_Low + channel->ADCMON_Hysteresis) :
+                          ADCMON_FullScale;
+        ADC1->WDLTR = 0;
+    }
+    else {
+        ADC1->WDHTR = channel->ADCMON_High;
+        ADC1->WDLTR = channel->ADCMON_Low;
+    }
+    ADC_AnalogWatchdogSingleChannelConfig(ADC1, channel->ADCMON_Channel);
+    ADC_RegularChannelConfig(ADC1, channel->ADCMON_Channel, 1, ADCMON_SampleTime);
+}
+
+/**
+ * @brief   Initializes ADC1 for limit supervision by the analog watchdog.
+ *        The ADC converts the watched channel continuously and compares
+ *        every reading in hardware; the CPU only runs when a reading
+ *        leaves its window, so the application can sleep with __WFI()
+ *        in between. Several channels are watched in turn, one per
+ *        ADCMON_Tick().
+ *          Events apply hysteresis by moving the window: after a reading
+ *        above ADCMON_High, the event ends once a reading drops below
+ *        ADCMON_High - ADCMON_Hysteresis, and likewise for ADCMON_Low.
+ *          ADCMON owns the regular group while running, so it does not
+ *        combine with ADCSCAN. Peripheral clocks, the analog pins, the
+ *        ADC1 NVIC channel and SysTick, which stamps the events, are
+ *        configured by the application, which calls ADCMON_IRQHandler()
+ *        from ADC1_IRQHandler().
+ * @param   ADCMON_InitStruct - pointer to a ADCMON_InitTypeDef structure.
+ * @return  none
+ */
+void ADCMON_Init(ADCMON_InitTypeDef *ADCMON_InitStruct) {
+    ADC_InitTypeDef ADC_InitStructure;
+    uint8_t         i;
+
+    ADCMON_Channels = ADCMON_InitStruct->ADCMON_Channels;
+    ADCMON_ChannelCount = ADCMON_InitStruct->ADCMON_ChannelCount;
+    ADCMON_SampleTime = ADCMON_InitStruct->ADCMON_SampleTime;
+    ADCMON_Index = 0;
+    for(i = 0; i < ADCMON_ChannelCount; i++) {
+        ADCMON_Channels[i].ADCMON_State = ADCMON_State_Normal;
+    }
+
+    ADC_DeInit(ADC1);
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ScanConvMode = DISABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = ENABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = 1;
+    ADC_Init(ADC1, &ADC_InitStructure);
+    ADCMON_Arm();
+    ADC_AnalogWatchdogCmd(ADC1, ADC_AnalogWatchdog_SingleRegEnable);
+
+    ADC_Cmd(ADC1, ENABLE);
+    ADC_ResetCalibration(ADC1);
+    while(ADC_GetResetCalibrationStatus(ADC1))
+        ;
+    ADC_StartCalibration(ADC1);
+    while(ADC_GetCalibrationStatus(ADC1))
+        ;
+}
+
+/**
+ * @brief   Fills each ADCMON_InitStruct member with its default value.
+ * @param   ADCMON_InitStruct - pointer to a ADCMON_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void ADCMON_StructInit(ADCMON_InitTypeDef *ADCMON_InitStruct) {
+    ADCMON_InitStruct->ADCMON_Channels = 0;
+    ADCMON_InitStruct->ADCMON_ChannelCount = 0;
+    ADCMON_InitStruct->ADCMON_SampleTime = ADC_SampleTime_57Cycles;
+}
+
+/**
+ * @brief   Starts supervision.
+ * @return  none
+ */
+void ADCMON_Start(void) {
+    ADC1->STATR = ~(uint32_t)ADC_AWD;
+    ADC_ITConfig(ADC1, ADC_IT_AWD, ENABLE);
+    ADC1->CTLR2 |= ADC_CONT;
+    ADC_SoftwareStartConvCmd(ADC1, ENABLE);
+}
+
+/**
+ * @brief   Stops supervision after the conversion in progress.
+ * @return  none
+ */
+void ADCMON_Stop(void) {
+    ADC1->CTLR2 &= ~ADC_CONT;
+    ADC_ITConfig(ADC1, ADC_IT_AWD, DISABLE);
+}
+
+/**
+ * @brief   Moves the watchdog to the next channel; call it from a timer
+ *        interrupt. The tick period is how long each channel is watched,
+ *        so a limit crossing is seen within ADCMON_ChannelCount ticks.
+ *        With a single channel no ticks are needed. A tick that finds an
+ *        event not yet handled leaves the channel in place, so the event
+ *        is credited to the channel that raised it.
+ * @return  none
+ */
+void ADCMON_Tick(void) {
+    uint32_t mstatus;
+
+    if(ADCMON_ChannelCount < 2) {
+        return;
+    }
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    if((ADC1->STATR & ADC_AWD) == 0) {
+        if(++ADCMON_Index == ADCMON_ChannelCount) {
+            ADCMON_Index = 0;
+        }
+        ADCMON_Arm();
+    }
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Handles an analog watchdog event: stamps it, moves the channel
+ *        to its new state and re-arms the window. Readings of a channel
+ *        in an event only reach here once they are back inside.
+ * @return  none
+ */
+void ADCMON_IRQHandler(void) {
+    ADCMON_ChannelTypeDef *channel;
+    uint32_t               timestamp = SysTick->CNT;
+    uint16_t               value;
+
+    if((ADC1->STATR & ADC_AWD) == 0) {
+        return;
+    }
+    value = (uint16_t)ADC1->RDATAR;
+    ADC1->STATR = ~(uint32_t)ADC_AWD;
+
+    channel = &ADCMON_Channels[ADCMON_Index];
+    if(channel->ADCMON_State != ADCMON_State_Normal) {
+        channel->ADCMON_State = ADCMON_State_Normal;
+    }
+    else if(value > channel->ADCMON_High) {
+        channel->ADCMON_State = ADCMON_State_High;
+    }
+    else {
+        channel->ADCMON_State = ADCMON_State_Low;
+    }
+    channel->ADCMON_Value = value;
+    channel->ADCMON_Timestamp = timestamp;
+    ADCMON_Arm();
+
+    if(channel->ADCMON_Callback != 0) {
+        channel->ADCMON_Callback(channel);
+    }
+}
@@ -0,0 +1,99 @@
+#include "ch32v00x_adcovs.h"
+#include "ch32v00x_adc.h"
+
+static uint32_t ADCOVS_Sums[ADCOVS_MaxChannels];
+static uint16_t ADCOVS_Results[ADCOVS_MaxChannels];
+static uint8_t  ADCOVS_ChannelCount = 0;
+static uint8_t  ADCOVS_ExtraBits = 0;
+static uint16_t ADCOVS_Scans = 0;
+static uint16_t ADCOVS_Count = 0;
+static uint16_t ADCOVS_DitherMask = 0;
+static uint16_t ADCOVS_Lfsr = 0xACE1;
+static void (*ADCOVS_Callback)(const uint16_t *Results) = 0;
+
+/**
+ * @brief   Initializes the oversampling engine. It sits on an ADCSCAN
+ *        ring: set ADCSCAN_Callback to ADCOVS_Process. Each channel sums
+ *        4^n scans and the sum is shifted right by n, giving n extra bits
+ *        at 1/4^n of the scan rate, with additions and shifts only.
+ *          The extra bits are only real when the input moves by about an
+ *        LSB between samples. Noise usually does that; periodic
+ *        interference locked to the sampling, such as PWM ripple with a
+ *        timer-triggered scan, does not and leaves a bias instead. The
+ *        dither breaks that lock: after every ring block the regular
+ *        trigger delay (ADC_ExternalTrig_DLY) moves to a new
+ *        pseudo-random value. The delay can only change between blocks,
+ *        so each result must span at least four blocks for its samples
+ *        to spread over the period: dither is only enabled when
+ *        ADCOVS_BlockScans is at most a quarter of 4^n, e.g. 4 scans per
+ *        block for 2 extra bits. Dither also needs ADCSCAN_Trigger on a
+ *        timer.
+ * @param   ADCOVS_InitStruct - pointer to a ADCOVS_InitTypeDef structure.
+ * @return  none
+ */
+void ADCOVS_Init(ADCOVS_InitTypeDef *ADCOVS_InitStruct) {
+    uint8_t i;
+
+    ADCOVS_ChannelCount = ADCOVS_InitStruct->ADCOVS_ChannelCount;
+    ADCOVS_ExtraBits = ADCOVS_InitStruct->ADCOVS_ExtraBits;
+    ADCOVS_Scans = (uint16_t)(1 << (ADCOVS_ExtraBits << 1));
+    ADCOVS_DitherMask = ADCOVS_InitStruct->ADCOVS_DitherMask;
+    if(ADCOVS_InitStruct->ADCOVS_BlockScans > (ADCOVS_Scans >> 2)) {
+        ADCOVS_DitherMask = 0;
+    }
+    ADCOVS_Callback = ADCOVS_InitStruct->ADCOVS_Callback;
+    ADCOVS_Count = 0;
+    for(i = 0; i < ADCOVS_MaxChannels; i++) {
+        ADCOVS_Sums[i] = 0;
+    }
+}
+
+/**
+ * @brief   Fills each ADCOVS_InitStruct member with its default value.
+ * @param   ADCOVS_InitStruct - pointer to a ADCOVS_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void ADCOVS_StructInit(ADCOVS_InitTypeDef *ADCOVS_InitStruct) {
+    ADCOVS_InitStruct->ADCOVS_ChannelCount = 1;
+    ADCOVS_InitStruct->ADCOVS_ExtraBits = 2;
+    ADCOVS_InitStruct->ADCOVS_BlockScans = 16;
+    ADCOVS_InitStruct->ADCOVS_DitherMask = 0;
+    ADCOVS_InitStruct->ADCOVS_Callback = 0;
+}
+
+/**
+ * @brief   Accumulates one block of interleaved scans, handing out results
+ *        whenever 4^n scans are summed. Results may span blocks. Has the
+ *        ADCSCAN_Callback signature.
+ * @param   Block - scans, samples interleaved in scan order.
+ *          Scans - number of scans in the block.
+ * @return  none
+ */
+void ADCOVS_Process(uint16_t *Block, uint16_t Scans) {
+    const uint16_t *sample = Block;
+    uint8_t         i;
+
+    while(Scans-- != 0) {
+        for(i = 0; i < ADCOVS_ChannelCount; i++) {
+            ADCOVS_Sums[i] += *sample++;
+        }
+        if(++ADCOVS_Count != ADCOVS_Scans) {
+            continue;
+        }
+        ADCOVS_Count = 0;
+        for(i = 0; i < ADCOVS_ChannelCount; i++) {
+            ADCOVS_Results[i] = (uint16_t)(ADCOVS_Sums[i] >> ADCOVS_ExtraBits);
+            ADCOVS_Sums[i] = 0;
+        }
+        if(ADCOVS_Callback != 0) {
+            ADCOVS_Callback(ADCOVS_Results);
+        }
+    }
+
+    if(ADCOVS_DitherMask != 0) {
+        /* 16-bit Galois LFSR, x^16 + x^14 + x^13 + x^11 + 1 */
+        ADCOVS_Lfsr = (uint16_t)((ADCOVS_Lfsr >> 1) ^ (-(ADCOVS_Lfsr & 0x01) & 0xB400));
+        ADC_ExternalTrig_DLY(ADC1, ADC_ExternalTrigRegul_DLY, ADCOVS_Lfsr & ADCOVS_DitherMask);
+    }
+}
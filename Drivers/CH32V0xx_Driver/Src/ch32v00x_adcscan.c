@@ -0,0 +1,237 @@
+#include "ch32v00x_adcscan.h"
+#include "ch32v00x_adc.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_rcc.h"
+#include "ch32v00x_tim.h"
+
+/* ADC1 DMA channel */
+#define ADCSCAN_DMA_Channel      DMA1_Channel1
+
+static uint16_t *ADCSCAN_Buffer = 0;
+static uint16_t  ADCSCAN_BlockSize = 0;
+static uint16_t  ADCSCAN_BlockScans = 0;
+static uint16_t  ADCSCAN_Overruns = 0;
+
+/* Trigger timer, 0 when free running; set when the rate is ours to program */
+static TIM_TypeDef *ADCSCAN_Timer = 0;
+static uint8_t      ADCSCAN_OwnTimer = 0;
+static void (*ADCSCAN_Callback)(uint16_t *Block, uint16_t Scans) = 0;
+
+/**
+ * @brief   Initializes ADC1 to scan a channel list continuously into a
+ *        circular DMA ring (DMA1 channel 1). The ring is split into two
+ *        blocks: while DMA fills one, the callback gets the other, so the
+ *        ADC runs at its full conversion rate without CPU involvement per
+ *        sample.
+ *          With a timer trigger each TRGO starts one scan, so samples are
+ *        taken on the timer clock with no software jitter. The trigger
+ *        delay shifts the sample point, e.g. away from a PWM edge when the
+ *        application drives TIM1 itself and leaves ADCSCAN_Rate at 0.
+ *          The ADC is calibrated here and left stopped; ADCSCAN_Start()
+ *        starts the scan.
+ *          Peripheral clocks (including the ADC prescaler and the trigger
+ *        timer), the analog pins and the DMA1_Channel1 NVIC channel are
+ *        configured by the application, which calls ADCSCAN_DMA_IRQHandler() from
+ *        DMA1_Channel1_IRQHandler().
+ * @param   ADCSCAN_InitStruct - pointer to a ADCSCAN_InitTypeDef structure.
+ * @return  none
+ */
+void ADCSCAN_Init(ADCSCAN_InitTypeDef *ADCSCAN_InitStruct) {
+    ADC_InitTypeDef ADC_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    uint8_t         i;
+
+    ADCSCAN_Buffer = ADCSCAN_InitStruct->ADCSCAN_Buffer;
+    ADCSCAN_BlockScans = ADCSCAN_InitStruct->ADCSCAN_BlockScans;
+    ADCSCAN_BlockSize = (uint16_t)(ADCSCAN_BlockScans * ADCSCAN_InitStruct->ADCSCAN_ChannelCount);
+    ADCSCAN_Callback = ADCSCAN_InitStruct->ADCSCAN_Callback;
+    ADCSCAN_Overruns = 0;
+    ADCSCAN_Timer = 0;
+    ADCSCAN_OwnTimer = 0;
+    if(ADCSCAN_InitStruct->ADCSCAN_Trigger == ADC_ExternalTrigConv_T1_TRGO) {
+        ADCSCAN_Timer = TIM1;
+    }
+    else if(ADCSCAN_InitStruct->ADCSCAN_Trigger == ADC_ExternalTrigConv_T2_TRGO) {
+        ADCSCAN_Timer = TIM2;
+    }
+
+    ADC_DeInit(ADC1);
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ScanConvMode = (ADCSCAN_InitStruct->ADCSCAN_ChannelCount > 1) ? ENABLE : DISABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = (ADCSCAN_Timer == 0) ? ENABLE : DISABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = (ADCSCAN_Timer == 0) ? ADC_ExternalTrigConv_None :
+                                                                      ADCSCAN_InitStruct->ADCSCAN_Trigger;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = ADCSCAN_InitStruct->ADCSCAN_ChannelCount;
+    ADC_Init(ADC1, &ADC_InitStructure);
+    for(i = 0; i < ADCSCAN_InitStruct->ADCSCAN_ChannelCount; i++) {
+        ADC_RegularChannelConfig(ADC1, ADCSCAN_InitStruct->ADCSCAN_Channels[i], (uint8_t)(i + 1),
+                                 ADCSCAN_InitStruct->ADCSCAN_SampleTime);
+    }
+    ADC_ExternalTrig_DLY(ADC1, ADC_ExternalTrigRegul_DLY, ADCSCAN_InitStruct->ADCSCAN_TriggerDelay);
+    if((ADCSCAN_Timer != 0) && (ADCSCAN_InitStruct->ADCSCAN_Rate != 0)) {
+        ADCSCAN_OwnTimer = 1;
+        ADCSCAN_SetRate(ADCSCAN_InitStruct->ADCSCAN_Rate);
+    }
+
+    DMA_DeInit(ADCSCAN_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->RDATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)ADCSCAN_Buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = (uint32_t)ADCSCAN_BlockSize << 1;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(ADCSCAN_DMA_Channel, &DMA_InitStructure);
+    DMA_ITConfig(ADCSCAN_DMA_Channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+    ADC_DMACmd(ADC1, ENABLE);
+    ADC_Cmd(ADC1, ENABLE);
+    ADC_ResetCalibration(ADC1);
+    while(ADC_GetResetCalibrationStatus(ADC1))
+        ;
+    ADC_StartCalibration(ADC1);
+    while(ADC_GetCalibrationStatus(ADC1))
+        ;
+}
+
+/**
+ * @brief   Fills each ADCSCAN_InitStruct member with its default value.
+ * @param   ADCSCAN_InitStruct - pointer to a ADCSCAN_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void ADCSCAN_StructInit(ADCSCAN_InitTypeDef *ADCSCAN_InitStruct) {
+    ADCSCAN_InitStruct->ADCSCAN_Channels = 0;
+    ADCSCAN_InitStruct->ADCSCAN_ChannelCount = 1;
+    ADCSCAN_InitStruct->ADCSCAN_SampleTime = ADC_SampleTime_15Cycles;
+    ADCSCAN_InitStruct->ADCSCAN_Buffer = 0;
+    ADCSCAN_InitStruct->ADCSCAN_BlockScans = 16;
+    ADCSCAN_InitStruct->ADCSCAN_Callback = 0;
+    ADCSCAN_InitStruct->ADCSCAN_Trigger = ADC_ExternalTrigConv_None;
+    ADCSCAN_InitStruct->ADCSCAN_Rate = 0;
+    ADCSCAN_InitStruct->ADCSCAN_TriggerDelay = 0;
+}
+
+/**
+ * @brief   Programs the trigger timer for a scan rate: the smallest
+ *        prescaler that fits the period in 16 bits, for the finest rate
+ *        step. The timer is left stopped until ADCSCAN_Start().
+ * @param   Rate - scans per second.
+ * @return  the rate actually obtained, rounded to 1 Hz, 0 if the timer
+ *        is not ours.
+ */
+uint32_t ADCSCAN_SetRate(uint32_t Rate) {
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+    RCC_ClocksTypeDef       RCC_ClocksStatus;
+    uint32_t                clock, ticks, prescaler;
+
+    if(!ADCSCAN_OwnTimer || (Rate == 0)) {
+        return 0;
+    }
+    RCC_GetClocksFreq(&RCC_ClocksStatus);
+    clock = (ADCSCAN_Timer == TIM1) ? RCC_ClocksStatus.PCLK2_Frequency : RCC_ClocksStatus.PCLK1_Frequency;
+    ticks = (clock + (Rate >> 1)) / Rate;
+    if(ticks < 2) {
+        ticks = 2;
+    }
+    prescaler = (ticks - 1) >> 16;
+    ticks = (ticks + (prescaler >> 1)) / (prescaler + 1);
+
+    TIM_TimeBaseStructInit(&TIM_TimeBaseInitStructure);
+    TIM_TimeBaseInitStructure.TIM_Prescaler = (uint16_t)prescaler;
+    TIM_TimeBaseInitStructure.TIM_Period = (uint16_t)(ticks - 1);
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(ADCSCAN_Timer, &TIM_TimeBaseInitStructure);
+    TIM_ARRPreloadConfig(ADCSCAN_Timer, ENABLE);
+    TIM_SelectOutputTrigger(ADCSCAN_Timer, TIM_TRGOSource_Update);
+
+    ticks *= prescaler + 1;
+    return (clock + (ticks >> 1)) / ticks;
+}
+
+/**
+ * @brief   Starts the scan from the beginning of the ring. After
+ *        ADCSCAN_Stop() the scan in progress must have ended first, which
+ *        takes at most one scan time.
+ * @return  none
+ */
+void ADCSCAN_Start(void) {
+    ADCSCAN_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+    ADCSCAN_DMA_Channel->CNTR = (uint32_t)ADCSCAN_BlockSize << 1;
+    DMA1->INTFCR = DMA1_FLAG_GL1;
+
+    /* Drop a sample left from the last scan so the ring starts at rank 1 */
+    (void)ADC1->RDATAR;
+    ADCSCAN_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+    if(ADCSCAN_Timer == 0) {
+        ADC1->CTLR2 |= ADC_CONT;
+        ADC_SoftwareStartConvCmd(ADC1, ENABLE);
+    }
+    else {
+        ADC_ExternalTrigConvCmd(ADC1, ENABLE);
+        if(ADCSCAN_OwnTimer) {
+            ADCSCAN_Timer->CNT = 0;
+            TIM_Cmd(ADCSCAN_Timer, ENABLE);
+        }
+    }
+}
+
+/**
+ * @brief   Stops the scan: the ADC finishes the scan in progress and
+ *        halts, its last samples are not stored.
+ * @return  none
+ */
+void ADCSCAN_Stop(void) {
+    if(ADCSCAN_Timer == 0) {
+        ADC1->CTLR2 &= ~ADC_CONT;
+    }
+    else {
+        ADC_ExternalTrigConvCmd(ADC1, DISABLE);
+        if(ADCSCAN_OwnTimer) {
+            TIM_Cmd(ADCSCAN_Timer, DISABLE);
+        }
+    }
+    ADCSCAN_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+}
+
+/**
+ * @brief   Gets the number of blocks the callback was too late for: DMA
+ *        had already filled the next block as well, so the block handed
+ *        over was partly overwritten.
+ * @return  the overrun count, saturating at 0xFFFF.
+ */
+uint16_t ADCSCAN_GetOverruns(void) {
+    return ADCSCAN_Overruns;
+}
+
+/**
+ * @brief   Hands the block DMA has just completed to the callback. The
+ *        block is chosen from the DMA position rather than the flag, so a
+ *        late interrupt still passes the most recent block.
+ * @return  none
+ */
+void ADCSCAN_DMA_IRQHandler(void) {
+    uint32_t  flags = DMA1->INTFR & (DMA1_FLAG_HT1 | DMA1_FLAG_TC1);
+    uint16_t *block = ADCSCAN_Buffer;
+
+    if(flags == 0) {
+        return;
+    }
+    DMA1->INTFCR = DMA1_FLAG_GL1;
+    if((flags == (DMA1_FLAG_HT1 | DMA1_FLAG_TC1)) && (ADCSCAN_Overruns != 0xFFFF)) {
+        ADCSCAN_Overruns++;
+    }
+
+    /* More than a block left means DMA is filling the first block again */
+    if(ADCSCAN_DMA_Channel->CNTR > ADCSCAN_BlockSize) {
+        block += ADCSCAN_BlockSize;
+    }
+    if(ADCSCAN_Callback != 0) {
+        ADCSCAN_Callback(block, ADCSCAN_BlockScans);
+    }
+}
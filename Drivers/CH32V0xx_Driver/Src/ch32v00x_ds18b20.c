@@ -0,0 +1,124 @@
+#include "ch32v00x_ds18b20.h"
+#include "ch32v00x_onewire.h"
+
+/* Scratchpad layout */
+#define DS18B20_SP_TempLSB       0
+#define DS18B20_SP_TempMSB       1
+#define DS18B20_SP_TH            2
+#define DS18B20_SP_TL            3
+#define DS18B20_SP_Config        4
+
+/* Conversion time at 12-bit resolution, in milliseconds */
+#define DS18B20_ConversionTime12 ((uint16_t)750)
+
+/**
+ * @brief   Starts a temperature conversion on one device or, with Skip
+ *        ROM, on every device on the bus at once.
+ *          Completion can be polled with DS18B20_GetConversionStatus()
+ *        or awaited for DS18B20_GetConversionTime() milliseconds.
+ * @param   Rom - 8-byte ROM code of the device, 0 for all devices.
+ * @return  READY if a presence pulse was seen, NoREADY otherwise.
+ */
+ErrorStatus DS18B20_StartConversion(const uint8_t *Rom) {
+    if(OW_Select(Rom) != READY) {
+        return NoREADY;
+    }
+    OW_WriteByte(DS18B20_CMD_ConvertT);
+    return READY;
+}
+
+/**
+ * @brief   Polls the conversion started by DS18B20_StartConversion() with a
+ *        single read slot. Not usable with parasite-powered devices.
+ * @return  SET once the conversion has finished, RESET while it is running.
+ */
+FlagStatus DS18B20_GetConversionStatus(void) {
+    return OW_TouchBit(1) ? SET : RESET;
+}
+
+/**
+ * @brief   Returns the worst-case conversion time for a resolution.
+ * @param   Resolution - a value of @ref DS18B20_resolution.
+ * @return  conversion time in milliseconds.
+ */
+uint16_t DS18B20_GetConversionTime(uint8_t Resolution) {
+    return DS18B20_ConversionTime12 >> (3 - ((Resolution >> 5) & 0x03));
+}
+
+/**
+ * @brief   Reads the 9-byte scratchpad and checks its CRC.
+ * @param   Rom - 8-byte ROM code of the device, 0 if it is alone on the bus.
+ *          Scratchpad - receives DS18B20_ScratchpadSize bytes.
+ * @return  READY if the device answered with a valid CRC, NoREADY otherwise.
+ */
+ErrorStatus DS18B20_ReadScratchpad(const uint8_t *Rom, uint8_t *Scratchpad) {
+    if(OW_Select(Rom) != READY) {
+        return NoREADY;
+    }
+    OW_WriteByte(DS18B20_CMD_ReadScratchpad);
+    OW_Read(Scratchpad, DS18B20_ScratchpadSize);
+
+    /* An all-ones scratchpad (bus stuck high) has a zero CRC too */
+    if((OW_CRC8(Scratchpad, DS18B20_ScratchpadSize) != 0) || (Scratchpad[DS18B20_SP_Config] == 0xFF)) {
+        return NoREADY;
+    }
+    return READY;
+}
+
+/**
+ * @brief   Reads the result of the last conversion.
+ * @param   Rom - 8-byte ROM code of the device, 0 if it is alone on the bus.
+ *          Temperature - receives the temperature in 1/16 degC; bits
+ *        undefined at the configured resolution are cleared.
+ * @return  READY if the scratchpad was read with a valid CRC, NoREADY
+ *        otherwise.
+ */
+ErrorStatus DS18B20_ReadTemperature(const uint8_t *Rom, int16_t *Temperature) {
+    uint8_t sp[DS18B20_ScratchpadSize];
+    int16_t raw;
+
+    if(DS18B20_ReadScratchpad(Rom, sp) != READY) {
+        return NoREADY;
+    }
+
+    raw = (int16_t)((sp[DS18B20_SP_TempMSB] << 8) | sp[DS18B20_SP_TempLSB]);
+    raw &= (int16_t)~((1 << (3 - ((sp[DS18B20_SP_Config] >> 5) & 0x03))) - 1);
+    *Temperature = raw;
+    return READY;
+}
+
+/**
+ * @brief   Sets the conversion resolution, keeping the alarm thresholds.
+ *        The setting is volatile until copied to EEPROM.
+ * @param   Rom - 8-byte ROM code of the device, 0 if it is alone on the bus.
+ *          Resolution - a value of @ref DS18B20_resolution.
+ * @return  READY if the device answered, NoREADY otherwise.
+ */
+ErrorStatus DS18B20_SetResolution(const uint8_t *Rom, uint8_t Resolution) {
+    uint8_t sp[DS18B20_ScratchpadSize];
+
+    if(DS18B20_ReadScratchpad(Rom, sp) != READY) {
+        return NoREADY;
+    }
+    if(OW_Select(Rom) != READY) {
+        return NoREADY;
+    }
+    OW_WriteByte(DS18B20_CMD_WriteScratchpad);
+    OW_WriteByte(sp[DS18B20_SP_TH]);
+    OW_WriteByte(sp[DS18B20_SP_TL]);
+    OW_WriteByte(Resolution);
+    return READY;
+}
+
+/**
+ * @brief   Converts a temperature in 1/16 degC to 1/100 degC using shifts
+ *        and adds only (x * 100 / 16).
+ * @param   Temperature - temperature in 1/16 degC.
+ * @return  temperature in 1/100 degC.
+ */
+int16_t DS18B20_ToCentiCelsius(int16_t Temperature) {
+    int32_t t = Temperature;
+
+    t = (t << 6) + (t << 5) + (t << 2);
+    return (int16_t)(t >> 4);
+}
@@ -0,0 +1,283 @@
+#include "ch32v00x_filter.h"
+
+/**
+ * @brief   Multiplies by a coefficient in signed power-of-two form with
+ *        shifts and adds only.
+ * @param   Coefficient - quantized coefficient.
+ *          Value - multiplicand.
+ * @return  the product.
+ */
+static int32_t FILTER_CSDMul(const FILTER_CSDTypeDef *Coefficient, int32_t Value) {
+    int32_t result = 0, term;
+    uint8_t i, shift;
+
+    for(i = 0; i < Coefficient->FILTER_Terms; i++) {
+        shift = Coefficient->FILTER_Shift[i];
+        term = (shift == 0) ? (int32_t)((uint32_t)Value << 1) : (Value >> (shift - 1));
+        if(Coefficient->FILTER_Negative & (1 << i)) {
+            result -= term;
+        }
+        else {
+            result += term;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief   Initializes a moving average over the last 2^Log2Length
+ *        samples, kept as a running sum so each sample costs one add, one
+ *        subtract and a shift whatever the window length.
+ * @param   Filter - filter to initialize.
+ *          History - 1 << Log2Length entries, cleared here.
+ *          Log2Length - window length as a power of two, up to 16.
+ * @return  none
+ */
+void FILTER_MAInit(FILTER_MATypeDef *Filter, uint16_t *History, uint8_t Log2Length) {
+    uint32_t i;
+
+    Filter->FILTER_History = History;
+    Filter->FILTER_Log2Length = Log2Length;
+    Filter->FILTER_Index = 0;
+    Filter->FILTER_Sum = 0;
+    for(i = 0; i < ((uint32_t)1 << Log2Length); i++) {
+        History[i] = 0;
+    }
+}
+
+/**
+ * @brief   Runs samples through a moving average. In and Out may be the
+ *        same buffer.
+ * @param   Filter - moving average.
+ *          In - first input sample, e.g. a channel of an ADCSCAN block.
+ *          Count - number of samples.
+ *          Stride - distance between input samples, the ADCSCAN channel
+ *            count for one channel of an interleaved block.
+ *          Out - receives Count outputs, at the same stride.
+ * @return  none
+ */
+void FILTER_MAProcess(FILTER_MATypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out) {
+    uint16_t *history = Filter->FILTER_History;
+    uint16_t  mask = (uint16_t)((1 << Filter->FILTER_Log2Length) - 1);
+    uint16_t  index = Filter->FILTER_Index;
+    uint32_t  sum = Filter->FILTER_Sum;
+    uint16_t  sample;
+
+    while(Count-- != 0) {
+        sample = *In;
+        sum += sample - history[index];
+        history[index] = sample;
+        index = (index + 1) & mask;
+        *Out = (uint16_t)(sum >> Filter->FILTER_Log2Length);
+        In += Stride;
+        Out += Stride;
+    }
+    Filter->FILTER_Index = index;
+    Filter->FILTER_Sum = sum;
+}
+
+/**
+ * @brief   Initializes an exponential smoother y += (x - y) * 2^-Shift.
+ *          The time constant is about 2^Shift samples.
+ * @param   Filter - filter to initialize.
+ *          Shift - smoothing factor as a power of two, up to 16.
+ *          Initial - starting output, e.g. the first sample.
+ * @return  none
+ */
+void FILTER_EMAInit(FILTER_EMATypeDef *Filter, uint8_t Shift, uint16_t Initial) {
+    Filter->FILTER_Shift = Shift;
+    Filter->FILTER_Accumulator = (int32_t)Initial << Shift;
+}
+
+/**
+ * @brief   Runs samples through an exponential smoother. The output is
+ *        rounded from the full precision accumulator, so small steps are
+ *        tracked exactly.
+ * @param   Filter - exponential smoother.
+ *          In - first input sample.
+ *          Count - number of samples.
+ *          Stride - distance between input samples.
+ *          Out - receives Count outputs, at the same stride.
+ * @return  none
+ */
+void FILTER_EMAProcess(FILTER_EMATypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out) {
+    int32_t acc = Filter->FILTER_Accumulator;
+    uint8_t shift = Filter->FILTER_Shift;
+    int32_t half = (shift != 0) ? ((int32_t)1 << (shift - 1)) : 0;
+
+    while(Count-- != 0) {
+        acc += (int32_t)*In - (acc >> shift);
+        *Out = (uint16_t)((acc + half) >> shift);
+        In += Stride;
+        Out += Stride;
+    }
+    Filter->FILTER_Accumulator = acc;
+}
+
+/**
+ * @brief   Initializes a CIC decimator: Order integrators at the input
+ *        rate, decimation by 2^Log2Rate and Order combs at the output
+ *        rate. The integrators wrap modulo 2^32, which the combs undo, so
+ *        no stage ever saturates.
+ * @param   Filter - filter to initialize.
+ *          Order - number of stages, 1 to FILTER_CICMaxOrder.
+ *          Log2Rate - decimation rate as a power of two.
+ * @return  none
+ */
+void FILTER_CICInit(FILTER_CICTypeDef *Filter, uint8_t Order, uint8_t Log2Rate) {
+    uint8_t i;
+
+    Filter->FILTER_Order = (Order > FILTER_CICMaxOrder) ? FILTER_CICMaxOrder : Order;
+    Filter->FILTER_Log2Rate = Log2Rate;
+    Filter->FILTER_Phase = 0;
+    for(i = 0; i < FILTER_CICMaxOrder; i++) {
+        Filter->FILTER_Integrator[i] = 0;
+        Filter->FILTER_Comb[i] = 0;
+    }
+}
+
+/**
+ * @brief   Runs samples through a CIC decimator. Outputs are scaled back
+ *        to the input range by a shift of the filter gain.
+ * @param   Filter - CIC decimator.
+ *          In - first input sample.
+ *          Count - number of input samples.
+ *          Stride - distance between input samples.
+ *          Out - receives the outputs, packed.
+ * @return  the number of outputs written.
+ */
+uint16_t FILTER_CICProcess(FILTER_CICTypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, uint16_t *Out) {
+    uint32_t *integrator = Filter->FILTER_Integrator;
+    uint32_t *comb = Filter->FILTER_Comb;
+    uint8_t   order = Filter->FILTER_Order;
+    uint16_t  rate = (uint16_t)(1 << Filter->FILTER_Log2Rate);
+    uint16_t  phase = Filter->FILTER_Phase;
+    uint16_t  outputs = 0;
+    uint8_t   gain = 0, i;
+    uint32_t  value, previous;
+
+    for(i = 0; i < order; i++) {
+        gain += Filter->FILTER_Log2Rate;
+    }
+
+    while(Count-- != 0) {
+        value = *In;
+        In += Stride;
+        for(i = 0; i < order; i++) {
+            integrator[i] += value;
+            value = integrator[i];
+        }
+        if(++phase != rate) {
+            continue;
+        }
+        phase = 0;
+        for(i = 0; i < order; i++) {
+            previous = comb[i];
+            comb[i] = value;
+            value -= previous;
+        }
+        Out[outputs++] = (uint16_t)(value >> gain);
+    }
+    Filter->FILTER_Phase = phase;
+
+    return outputs;
+}
+
+/**
+ * @brief   Quantizes a coefficient to FILTER_CSDTerms signed powers of
+ *        two, each term taking the power nearest to what is left. Two or
+ *        three terms usually keep a coefficient within 1-3%; check the
+ *        result with FILTER_CSDValue() when poles sit close to the unit
+ *        circle.
+ * @param   Coefficient - receives the quantized form.
+ *          Value - coefficient in Q14, -2.0 to just under 2.0.
+ * @return  none
+ */
+void FILTER_CSDQuantize(FILTER_CSDTypeDef *Coefficient, int16_t Value) {
+    int32_t  residual = Value;
+    uint32_t magnitude;
+    uint8_t  k;
+
+    Coefficient->FILTER_Terms = 0;
+    Coefficient->FILTER_Negative = 0;
+    while((residual != 0) && (Coefficient->FILTER_Terms < FILTER_CSDTerms)) {
+        magnitude = (residual < 0) ? (uint32_t)-residual : (uint32_t)residual;
+        for(k = 0; (k < 15) && ((magnitude >> (k + 1)) != 0); k++)
+            ;
+        /* Round up to the next power when it is nearer */
+        if((k < 15) && (((uint32_t)2 << k) - magnitude < magnitude - ((uint32_t)1 << k))) {
+            k++;
+        }
+        if(residual < 0) {
+            Coefficient->FILTER_Negative |= (uint8_t)(1 << Coefficient->FILTER_Terms);
+            residual += (int32_t)1 << k;
+        }
+        else {
+            residual -= (int32_t)1 << k;
+        }
+        Coefficient->FILTER_Shift[Coefficient->FILTER_Terms++] = (uint8_t)(15 - k);
+    }
+}
+
+/**
+ * @brief   Gets the value a quantized coefficient actually applies.
+ * @param   Coefficient - quantized coefficient.
+ * @return  the coefficient in Q14, 32768 standing for 2.0.
+ */
+int32_t FILTER_CSDValue(const FILTER_CSDTypeDef *Coefficient) {
+    return FILTER_CSDMul(Coefficient, (int32_t)1 << 14);
+}
+
+/**
+ * @brief   Initializes a biquad from Q14 coefficients, quantized to
+ *        signed power-of-two terms so the filter runs on shifts and adds.
+ *        The transfer function is
+ *        (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+ * @param   Filter - filter to initialize.
+ *          Coefficients - b0, b1, b2, a1, a2 in Q14.
+ * @return  none
+ */
+void FILTER_BiquadInit(FILTER_BiquadTypeDef *Filter, const int16_t *Coefficients) {
+    uint8_t i;
+
+    for(i = 0; i < 3; i++) {
+        FILTER_CSDQuantize(&Filter->FILTER_B[i], Coefficients[i]);
+    }
+    for(i = 0; i < 2; i++) {
+        FILTER_CSDQuantize(&Filter->FILTER_A[i], Coefficients[3 + i]);
+        Filter->FILTER_X[i] = 0;
+        Filter->FILTER_Y[i] = 0;
+    }
+}
+
+/**
+ * @brief   Runs samples through a biquad. The state keeps
+ *        FILTER_BiquadFrac fractional bits; outputs are rounded and
+ *        saturated to 16 bits.
+ * @param   Filter - biquad.
+ *          In - first input sample.
+ *          Count - number of samples.
+ *          Stride - distance between input samples.
+ *          Out - receives Count outputs, at the same stride.
+ * @return  none
+ */
+void FILTER_BiquadProcess(FILTER_BiquadTypeDef *Filter, const uint16_t *In, uint16_t Count, uint8_t Stride, int16_t *Out) {
+    int32_t x, y;
+
+    while(Count-- != 0) {
+        x = (int32_t)*In << FILTER_BiquadFrac;
+        y = FILTER_CSDMul(&Filter->FILTER_B[0], x) + FILTER_CSDMul(&Filter->FILTER_B[1], Filter->FILTER_X[0]) +
+            FILTER_CSDMul(&Filter->FILTER_B[2], Filter->FILTER_X[1]) -
+            FILTER_CSDMul(&Filter->FILTER_A[0], Filter->FILTER_Y[0]) -
+            FILTER_CSDMul(&Filter->FILTER_A[1], Filter->FILTER_Y[1]);
+        Filter->FILTER_X[1] = Filter->FILTER_X[0];
+        Filter->FILTER_X[0] = x;
+        Filter->FILTER_Y[1] = Filter->FILTER_Y[0];
+        Filter->FILTER_Y[0] = y;
+
+        y = (y + (1 << (FILTER_BiquadFrac - 1))) >> FILTER_BiquadFrac;
+        *Out = (int16_t)((y > 32767) ? 32767 : ((y < -32768) ? -32768 : y));
+        In += Stride;
+        Out += Stride;
+    }
+}
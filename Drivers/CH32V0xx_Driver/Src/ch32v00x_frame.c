@@ -0,0 +1,385 @@
+#include "ch32v00x_frame.h"
+#include "ch32v00x_usart.h"
+
+/* COBS block code for a run of 254 non-zero bytes without a trailing zero */
+#define FRAME_COBS_MAX_CODE      ((uint8_t)0xFF)
+
+/* Receiver state */
+static uint8_t  *FRAME_RxBuf = 0;
+static uint16_t  FRAME_RxSize = 0;
+static uint16_t  FRAME_RxLen = 0;
+static uint16_t  FRAME_RxDoneLen = 0;
+static uint16_t  FRAME_RxCrc = FRAME_CRC16_INIT;
+static uint8_t   FRAME_RxCode = 0;
+static uint8_t   FRAME_RxCount = 0;
+static uint8_t   FRAME_RxEscape = 0;
+static uint8_t   FRAME_RxFault = 0;
+static uint16_t  FRAME_Errors = 0;
+
+/* Transmitter state */
+static const uint8_t *FRAME_TxData = 0;
+static uint16_t  FRAME_TxLen = 0;
+static uint16_t  FRAME_TxPos = 0;
+static uint16_t  FRAME_TxCrc = 0;
+static uint8_t   FRAME_TxRun = 0;
+static uint8_t   FRAME_TxSkipZero = 0;
+static uint8_t   FRAME_TxPending = 0;
+static uint8_t   FRAME_TxState = 0;
+
+static uint8_t   FRAME_Mode = FRAME_Encoding_COBS;
+static void (*FRAME_Callback)(uint8_t *Data, uint16_t Length) = 0;
+
+/* Transmitter states */
+#define FRAME_TX_IDLE            ((uint8_t)0x00)
+#define FRAME_TX_START           ((uint8_t)0x01)
+#define FRAME_TX_DATA            ((uint8_t)0x02)
+#define FRAME_TX_END             ((uint8_t)0x03)
+
+/**
+ * @brief   Updates a CRC-16/CCITT-FALSE (poly 0x1021) with one byte.
+ *        Table-free and multiply-free, a fixed handful of shifts and
+ *        XORs per byte so it is cheap enough for the RX interrupt.
+ * @param   Crc - current CRC value, FRAME_CRC16_INIT for a new frame.
+ *          Data - byte to add.
+ * @return  updated CRC value.
+ */
+uint16_t FRAME_CRC16Update(uint16_t Crc, uint8_t Data) {
+    uint16_t x;
+
+    x = (uint8_t)((Crc >> 8) ^ Data);
+    x ^= x >> 4;
+    return (uint16_t)((Crc << 8) ^ (x << 12) ^ (x << 5) ^ x);
+}
+
+/**
+ * @brief   Stores one decoded payload byte and folds it into the CRC.
+ * @param   Data - decoded byte.
+ * @return  none
+ */
+static void FRAME_RxPut(uint8_t Data) {
+    if(FRAME_RxLen < FRAME_RxSize) {
+        FRAME_RxBuf[FRAME_RxLen++] = Data;
+        FRAME_RxCrc = FRAME_CRC16Update(FRAME_RxCrc, Data);
+    }
+    else {
+        FRAME_RxFault = 1;
+    }
+}
+
+/**
+ * @brief   Closes the frame being received and checks its CRC.
+ * @return  FRAME_EVENT_NONE, FRAME_EVENT_FRAME or FRAME_EVENT_ERROR.
+ */
+static uint8_t FRAME_RxEnd(void) {
+    uint8_t event = FRAME_EVENT_NONE;
+
+    if((FRAME_RxLen != 0) || FRAME_RxFault) {
+        if(!FRAME_RxFault && (FRAME_RxLen >= 2) && (FRAME_RxCrc == 0)) {
+            FRAME_RxDoneLen = FRAME_RxLen - 2;
+            event = FRAME_EVENT_FRAME;
+        }
+        else {
+            FRAME_Errors++;
+            event = FRAME_EVENT_ERROR;
+        }
+    }
+
+    FRAME_RxLen = 0;
+    FRAME_RxCrc = FRAME_CRC16_INIT;
+    FRAME_RxCode = 0;
+    FRAME_RxCount = 0;
+    FRAME_RxEscape = 0;
+    FRAME_RxFault = 0;
+
+    return event;
+}
+
+/**
+ * @brief   Initializes the framing layer on USART1 according to the
+ *        specified parameters in the FRAME_InitStruct.
+ *          USART1, its pins and the USART1 NVIC channel must be configured
+ *        by the application; this function enables the RXNE interrupt.
+ *        FRAME_IRQHandler() has to be called from USART1_IRQHandler().
+ * @param   FRAME_InitStruct - pointer to a FRAME_InitTypeDef structure.
+ * @return  none
+ */
+void FRAME_Init(FRAME_InitTypeDef *FRAME_InitStruct) {
+    USART_ITConfig(USART1, USART_IT_RXNE, DISABLE);
+    USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+
+    FRAME_Mode = FRAME_InitStruct->FRAME_Encoding;
+    FRAME_RxBuf = FRAME_InitStruct->FRAME_RxBuffer;
+    FRAME_RxSize = FRAME_InitStruct->FRAME_RxBufferSize;
+    FRAME_Callback = FRAME_InitStruct->FRAME_RxCallback;
+    FRAME_Errors = 0;
+    FRAME_TxState = FRAME_TX_IDLE;
+    FRAME_Reset();
+
+    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+}
+
+/**
+ * @brief   Fills each FRAME_InitStruct member with its default value.
+ * @param   FRAME_InitStruct - pointer to a FRAME_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void FRAME_StructInit(FRAME_InitTypeDef *FRAME_InitStruct) {
+    FRAME_InitStruct->FRAME_Encoding = FRAME_Encoding_COBS;
+    FRAME_InitStruct->FRAME_RxBuffer = 0;
+    FRAME_InitStruct->FRAME_RxBufferSize = 0;
+    FRAME_InitStruct->FRAME_RxCallback = 0;
+}
+
+/**
+ * @brief   Discards the frame currently being received.
+ * @return  none
+ */
+void FRAME_Reset(void) {
+    FRAME_RxLen = 0;
+    FRAME_RxDoneLen = 0;
+    FRAME_RxCrc = FRAME_CRC16_INIT;
+    FRAME_RxCode = 0;
+    FRAME_RxCount = 0;
+    FRAME_RxEscape = 0;
+    FRAME_RxFault = 0;
+}
+
+/**
+ * @brief   Feeds one received wire byte to the decoder.
+ *          The work per byte is constant: the byte is unstuffed straight
+ *        into FRAME_RxBuffer and the CRC is updated in place, so a complete
+ *        frame is never copied or parsed a second time.
+ * @param   Data - byte read from the USART.
+ * @return  FRAME_EVENT_NONE, FRAME_EVENT_FRAME or FRAME_EVENT_ERROR.
+ */
+uint8_t FRAME_RxByte(uint8_t Data) {
+    if(FRAME_Mode == FRAME_Encoding_COBS) {
+        if(Data == 0) {
+            if(FRAME_RxCount != 0) {
+                FRAME_RxFault = 1;
+            }
+            return FRAME_RxEnd();
+        }
+        if(FRAME_RxCount == 0) {
+            if((FRAME_RxCode != 0) && (FRAME_RxCode != FRAME_COBS_MAX_CODE)) {
+                FRAME_RxPut(0);
+            }
+            FRAME_RxCode = Data;
+            FRAME_RxCount = Data - 1;
+        }
+        else {
+            FRAME_RxPut(Data);
+            FRAME_RxCount--;
+        }
+    }
+    else {
+        if(Data == FRAME_SLIP_END) {
+            if(FRAME_RxEscape) {
+                FRAME_RxFault = 1;
+            }
+            return FRAME_RxEnd();
+        }
+        if(FRAME_RxEscape) {
+            FRAME_RxEscape = 0;
+            if(Data == FRAME_SLIP_ESC_END) {
+                FRAME_RxPut(FRAME_SLIP_END);
+            }
+            else if(Data == FRAME_SLIP_ESC_ESC) {
+                FRAME_RxPut(FRAME_SLIP_ESC);
+            }
+            else {
+                FRAME_RxFault = 1;
+            }
+        }
+        else if(Data == FRAME_SLIP_ESC) {
+            FRAME_RxEscape = 1;
+        }
+        else {
+            FRAME_RxPut(Data);
+        }
+    }
+
+    return FRAME_EVENT_NONE;
+}
+
+/**
+ * @brief   Returns the payload length of the last frame reported by
+ *        FRAME_EVENT_FRAME, CRC bytes excluded.
+ * @return  payload length in bytes.
+ */
+uint16_t FRAME_GetRxLength(void) {
+    return FRAME_RxDoneLen;
+}
+
+/**
+ * @brief   Returns the byte at position Index of the payload followed by
+ *        its two CRC bytes (MSB first).
+ * @param   Index - position, 0 to FRAME_TxLen + 1.
+ * @return  byte value.
+ */
+static uint8_t FRAME_TxPeek(uint16_t Index) {
+    if(Index < FRAME_TxLen) {
+        return FRAME_TxData[Index];
+    }
+    if(Index == FRAME_TxLen) {
+        return (uint8_t)(FRAME_TxCrc >> 8);
+    }
+    return (uint8_t)FRAME_TxCrc;
+}
+
+/**
+ * @brief   Produces the next wire byte of the frame being transmitted.
+ *          COBS looks ahead at most 254 bytes once per block, so the cost
+ *        stays constant per byte on average.
+ * @param   Data - pointer to the byte to send.
+ * @return  SET if Data holds a byte, RESET when the frame is complete.
+ */
+static FlagStatus FRAME_TxNext(uint8_t *Data) {
+    uint16_t total = FRAME_TxLen + 2;
+    uint8_t  byte;
+    uint8_t  run;
+
+    if(FRAME_TxState == FRAME_TX_START) {
+        FRAME_TxState = FRAME_TX_DATA;
+        if(FRAME_Mode == FRAME_Encoding_SLIP) {
+            *Data = FRAME_SLIP_END;
+            return SET;
+        }
+    }
+    if(FRAME_TxState == FRAME_TX_END) {
+        FRAME_TxState = FRAME_TX_IDLE;
+        return RESET;
+    }
+
+    if(FRAME_Mode == FRAME_Encoding_COBS) {
+        if(FRAME_TxRun != 0) {
+            FRAME_TxRun--;
+            *Data = FRAME_TxPeek(FRAME_TxPos++);
+            if((FRAME_TxRun == 0) && FRAME_TxSkipZero) {
+                FRAME_TxPos++;
+            }
+            return SET;
+        }
+        /* The payload is followed by an implicit zero at index total */
+        if(FRAME_TxPos > total) {
+            FRAME_TxState = FRAME_TX_END;
+            *Data = 0;
+            return SET;
+        }
+        run = 0;
+        while((run < (FRAME_COBS_MAX_CODE - 1)) && ((FRAME_TxPos + run) < total) &&
+              (FRAME_TxPeek(FRAME_TxPos + run) != 0)) {
+            run++;
+        }
+        FRAME_TxSkipZero = (run < (FRAME_COBS_MAX_CODE - 1)) ? 1 : 0;
+        FRAME_TxRun = run;
+        if((run == 0) && FRAME_TxSkipZero) {
+            FRAME_TxPos++;
+        }
+        *Data = run + 1;
+        return SET;
+    }
+
+    if(FRAME_TxPending != 0) {
+        *Data = FRAME_TxPending;
+        FRAME_TxPending = 0;
+        return SET;
+    }
+    if(FRAME_TxPos >= total) {
+        FRAME_TxState = FRAME_TX_END;
+        *Data = FRAME_SLIP_END;
+        return SET;
+    }
+    byte = FRAME_TxPeek(FRAME_TxPos++);
+    if(byte == FRAME_SLIP_END) {
+        FRAME_TxPending = FRAME_SLIP_ESC_END;
+        byte = FRAME_SLIP_ESC;
+    }
+    else if(byte == FRAME_SLIP_ESC) {
+        FRAME_TxPending = FRAME_SLIP_ESC_ESC;
+    }
+    *Data = byte;
+    return SET;
+}
+
+/**
+ * @brief   Starts interrupt-driven transmission of one frame.
+ *          The payload is encoded on the fly from Data, which must stay
+ *        valid until FRAME_GetTxBusy() returns RESET.
+ * @param   Data - payload to send.
+ *          Length - payload length in bytes.
+ * @return  READY if the frame was queued, NoREADY if a frame is still
+ *        being transmitted.
+ */
+ErrorStatus FRAME_Send(const uint8_t *Data, uint16_t Length) {
+    uint16_t crc = FRAME_CRC16_INIT;
+    uint16_t i;
+
+    if(FRAME_TxState != FRAME_TX_IDLE) {
+        return NoREADY;
+    }
+
+    for(i = 0; i < Length; i++) {
+        crc = FRAME_CRC16Update(crc, Data[i]);
+    }
+
+    FRAME_TxData = Data;
+    FRAME_TxLen = Length;
+    FRAME_TxCrc = crc;
+    FRAME_TxPos = 0;
+    FRAME_TxRun = 0;
+    FRAME_TxSkipZero = 0;
+    FRAME_TxPending = 0;
+    FRAME_TxState = FRAME_TX_START;
+
+    USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+
+    return READY;
+}
+
+/**
+ * @brief   Checks whether a frame is still being transmitted.
+ * @return  SET while busy, RESET when a new frame can be sent.
+ */
+FlagStatus FRAME_GetTxBusy(void) {
+    return (FRAME_TxState != FRAME_TX_IDLE) ? SET : RESET;
+}
+
+/**
+ * @brief   Returns the number of frames dropped because of CRC, stuffing,
+ *        overrun or length errors since FRAME_Init().
+ * @return  error count.
+ */
+uint16_t FRAME_GetErrorCount(void) {
+    return FRAME_Errors;
+}
+
+/**
+ * @brief   Services the USART1 RXNE and TXE interrupts for the framing
+ *        layer. Must be called from USART1_IRQHandler().
+ * @return  none
+ */
+void FRAME_IRQHandler(void) {
+    uint16_t statr = USART1->STATR;
+    uint8_t  data;
+
+    if(statr & (USART_STATR_RXNE | USART_STATR_ORE)) {
+        data = (uint8_t)USART1->DATAR;
+        if(statr & USART_STATR_ORE) {
+            FRAME_RxFault = 1;
+        }
+        if((FRAME_RxByte(data) == FRAME_EVENT_FRAME) && (FRAME_Callback != 0)) {
+            FRAME_Callback(FRAME_RxBuf, FRAME_RxDoneLen);
+        }
+    }
+
+    if((statr & USART_STATR_TXE) && (USART1->CTLR1 & USART_CTLR1_TXEIE)) {
+        if(FRAME_TxNext(&data) == SET) {
+            USART1->DATAR = data;
+        }
+        else {
+            USART1->CTLR1 &= (uint16_t)~USART_CTLR1_TXEIE;
+        }
+    }
+}
@@ -0,0 +1,549 @@
+#include "ch32v00x_gfx.h"
+#include "ch32v00x_spibus.h"
+
+/* Controller commands used while streaming */
+#define GFX_SSD1306_ColumnAddr   ((uint8_t)0x21)
+#define GFX_SSD1306_PageAddr     ((uint8_t)0x22)
+#define GFX_ST7735_CASET         ((uint8_t)0x2A)
+#define GFX_ST7735_RASET         ((uint8_t)0x2B)
+#define GFX_ST7735_RAMWR         ((uint8_t)0x2C)
+
+#define GFX_TilePixels           (GFX_TileWidth * GFX_TileHeight)
+#define GFX_MaxTiles             ((GFX_MaxWidth / GFX_TileWidth) * (GFX_MaxHeight / GFX_TileHeight))
+
+/* Classic 5x7 font, ASCII 0x20 to 0x7E, one byte per column, LSB at the top */
+static const uint8_t GFX_Font[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x14, 0x08, 0x3E, 0x08, 0x14}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+};
+
+static const uint8_t GFX_CmdCaset = GFX_ST7735_CASET;
+static const uint8_t GFX_CmdRaset = GFX_ST7735_RASET;
+static const uint8_t GFX_CmdRamwr = GFX_ST7735_RAMWR;
+
+static SPIBUS_DeviceTypeDef      GFX_Device;
+static SPIBUS_TransactionTypeDef GFX_Tr[2][6];
+static SPIBUS_TransactionTypeDef GFX_TrCmd[2];
+static uint8_t                   GFX_Param[2][8];
+
+/* Two tiles: one is drawn while the other streams out */
+static uint16_t  GFX_Tile[2][GFX_TilePixels];
+static uint16_t *GFX_Target = 0;
+static uint8_t   GFX_Buf = 0;
+static int16_t   GFX_TileX = 0;
+static int16_t   GFX_TileY = 0;
+
+static uint8_t   GFX_Dirty[(GFX_MaxTiles + 7) / 8];
+static uint8_t   GFX_Columns = 0;
+static uint8_t   GFX_Rows = 0;
+
+static uint8_t        GFX_Mono = 1;
+static uint8_t        GFX_XOff = 0;
+static uint8_t        GFX_YOff = 0;
+static uint16_t       GFX_Bg = 0;
+static GPIO_TypeDef  *GFX_DCGpio = 0;
+static uint16_t       GFX_DCMask = 0;
+static void (*GFX_Draw)(void) = 0;
+
+/*
+ * D/C is switched from the completion callbacks so it follows the SPI
+ * queue: a command phase raises it for the data behind it, a data phase
+ * drops it again. It is therefore low whenever the display is idle.
+ */
+static void GFX_DCHigh(SPIBUS_TransactionTypeDef *Transaction) {
+    GFX_DCGpio->BSHR = GFX_DCMask;
+}
+
+static void GFX_DCLow(SPIBUS_TransactionTypeDef *Transaction) {
+    GFX_DCGpio->BCR = GFX_DCMask;
+}
+
+static void GFX_Queue(SPIBUS_TransactionTypeDef *Transaction, const uint8_t *Data, uint16_t Length, uint8_t Flags,
+                      void (*Callback)(SPIBUS_TransactionTypeDef *Transaction)) {
+    Transaction->SPIBUS_Device = &GFX_Device;
+    Transaction->SPIBUS_TxData = Data;
+    Transaction->SPIBUS_RxData = 0;
+    Transaction->SPIBUS_Length = Length;
+    Transaction->SPIBUS_Flags = Flags;
+    Transaction->SPIBUS_Callback = Callback;
+    SPIBUS_Submit(Transaction);
+}
+
+/**
+ * @brief   Waits until a tile buffer has been streamed out.
+ * @param   Buf - tile buffer index.
+ * @return  none
+ */
+static void GFX_WaitBuffer(uint8_t Buf) {
+    SPIBUS_TransactionTypeDef *last = &GFX_Tr[Buf][GFX_Mono ? 1 : 5];
+
+    while(last->SPIBUS_Status == SPIBUS_Status_Pending)
+        ;
+}
+
+/**
+ * @brief   Queues the address window and pixel data of the current tile.
+ * @return  none
+ */
+static void GFX_StreamTile(void) {
+    SPIBUS_TransactionTypeDef *tr = GFX_Tr[GFX_Buf];
+    uint8_t                   *p = GFX_Param[GFX_Buf];
+    uint16_t                   x = GFX_TileX + GFX_XOff;
+    uint16_t                   y = GFX_TileY + GFX_YOff;
+
+    if(GFX_Mono) {
+        p[0] = GFX_SSD1306_ColumnAddr;
+        p[1] = (uint8_t)x;
+        p[2] = (uint8_t)(x + GFX_TileWidth - 1);
+        p[3] = GFX_SSD1306_PageAddr;
+        p[4] = (uint8_t)(y >> 3);
+        p[5] = (uint8_t)(y >> 3);
+        GFX_Queue(&tr[0], p, 6, SPIBUS_Flag_None, GFX_DCHigh);
+        GFX_Queue(&tr[1], (const uint8_t *)GFX_Target, GFX_TileWidth, SPIBUS_Flag_None, GFX_DCLow);
+    }
+    else {
+        p[0] = (uint8_t)(x >> 8);
+        p[1] = (uint8_t)x;
+        p[2] = (uint8_t)((x + GFX_TileWidth - 1) >> 8);
+        p[3] = (uint8_t)(x + GFX_TileWidth - 1);
+        p[4] = (uint8_t)(y >> 8);
+        p[5] = (uint8_t)y;
+        p[6] = (uint8_t)((y + GFX_TileHeight - 1) >> 8);
+        p[7] = (uint8_t)(y + GFX_TileHeight - 1);
+        GFX_Queue(&tr[0], &GFX_CmdCaset, 1, SPIBUS_Flag_None, GFX_DCHigh);
+        GFX_Queue(&tr[1], &p[0], 4, SPIBUS_Flag_None, GFX_DCLow);
+        GFX_Queue(&tr[2], &GFX_CmdRaset, 1, SPIBUS_Flag_None, GFX_DCHigh);
+        GFX_Queue(&tr[3], &p[4], 4, SPIBUS_Flag_None, GFX_DCLow);
+        GFX_Queue(&tr[4], &GFX_CmdRamwr, 1, SPIBUS_Flag_None, GFX_DCHigh);
+        GFX_Queue(&tr[5], (const uint8_t *)GFX_Target, GFX_TilePixels, SPIBUS_Flag_16Bit, GFX_DCLow);
+    }
+}
+
+/**
+ * @brief   Clears a tile, lets the application draw into it and streams it.
+ * @param   Column - tile column.
+ *          Row - tile row.
+ * @return  none
+ */
+static void GFX_RenderTile(uint8_t Column, uint8_t Row) {
+    uint16_t fill = GFX_Bg;
+    uint8_t  i;
+
+    GFX_WaitBuffer(GFX_Buf);
+    GFX_Target = GFX_Tile[GFX_Buf];
+    GFX_TileX = (int16_t)Column * GFX_TileWidth;
+    GFX_TileY = (int16_t)Row * GFX_TileHeight;
+
+    if(GFX_Mono) {
+        fill = fill ? 0xFFFF : 0x0000;
+        for(i = 0; i < GFX_TileWidth / 2; i++) {
+            GFX_Target[i] = fill;
+        }
+    }
+    else {
+        for(i = 0; i < GFX_TilePixels; i++) {
+            GFX_Target[i] = fill;
+        }
+    }
+
+    if(GFX_Draw != 0) {
+        GFX_Draw();
+    }
+    GFX_StreamTile();
+    GFX_Buf ^= 1;
+}
+
+/**
+ * @brief   Writes one pixel already known to be inside the current tile.
+ * @return  none
+ */
+static void GFX_Plot(int16_t X, int16_t Y, uint16_t Colour) {
+    uint8_t lx = (uint8_t)(X - GFX_TileX);
+    uint8_t ly = (uint8_t)(Y - GFX_TileY);
+
+    if(GFX_Mono) {
+        if(Colour) {
+            ((uint8_t *)GFX_Target)[lx] |= (uint8_t)(1 << ly);
+        }
+        else {
+            ((uint8_t *)GFX_Target)[lx] &= (uint8_t)~(1 << ly);
+        }
+    }
+    else {
+        GFX_Target[(ly << 4) + lx] = Colour;
+    }
+}
+
+/**
+ * @brief   Checks whether a rectangle touches the current tile.
+ * @return  SET if it does, RESET otherwise.
+ */
+static FlagStatus GFX_Touches(int16_t X, int16_t Y, int16_t Width, int16_t Height) {
+    if((X >= GFX_TileX + GFX_TileWidth) || (X + Width <= GFX_TileX) ||
+       (Y >= GFX_TileY + GFX_TileHeight) || (Y + Height <= GFX_TileY)) {
+        return RESET;
+    }
+    return SET;
+}
+
+/**
+ * @brief   Initializes the tile renderer for an SSD1306 or ST7735 panel on
+ *        the SPI1 DMA engine.
+ *          Only two tiles are held in RAM: one is drawn by the CPU while
+ *        the other streams out by DMA. Tiles are re-drawn only when marked
+ *        dirty with GFX_Invalidate().
+ *          SPIBUS_Init() must have been called. The chip select and D/C
+ *        pins must be push-pull outputs; panel reset and its power-up
+ *        command sequence are sent by the application, e.g. with
+ *        GFX_WriteCommand(). The SSD1306 must use horizontal addressing.
+ * @param   GFX_InitStruct - pointer to a GFX_InitTypeDef structure.
+ * @return  none
+ */
+void GFX_Init(GFX_InitTypeDef *GFX_InitStruct) {
+    SPI_InitTypeDef SPI_InitStructure;
+
+    GFX_Mono = (GFX_InitStruct->GFX_Controller == GFX_Controller_SSD1306);
+    GFX_Columns = (uint8_t)(GFX_InitStruct->GFX_Width / GFX_TileWidth);
+    GFX_Rows = (uint8_t)(GFX_InitStruct->GFX_Height / GFX_TileHeight);
+    GFX_XOff = GFX_InitStruct->GFX_XOffset;
+    GFX_YOff = GFX_InitStruct->GFX_YOffset;
+    GFX_Bg = GFX_InitStruct->GFX_Background;
+    GFX_DCGpio = GFX_InitStruct->GFX_DCPort;
+    GFX_DCMask = GFX_InitStruct->GFX_DCPin;
+    GFX_Draw = GFX_InitStruct->GFX_DrawCallback;
+    GFX_Buf = 0;
+
+    GFX_DCGpio->BCR = GFX_DCMask;
+
+    SPI_StructInit(&SPI_InitStructure);
+    SPI_InitStructure.SPI_BaudRatePrescaler = GFX_InitStruct->GFX_BaudRatePrescaler;
+    SPIBUS_DeviceInit(&GFX_Device, &SPI_InitStructure, GFX_InitStruct->GFX_CSPort, GFX_InitStruct->GFX_CSPin);
+
+    GFX_InvalidateAll();
+}
+
+/**
+ * @brief   Fills each GFX_InitStruct member with its default value
+ *        (128x64 SSD1306).
+ * @param   GFX_InitStruct - pointer to a GFX_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void GFX_StructInit(GFX_InitTypeDef *GFX_InitStruct) {
+    GFX_InitStruct->GFX_Controller = GFX_Controller_SSD1306;
+    GFX_InitStruct->GFX_Width = 128;
+    GFX_InitStruct->GFX_Height = 64;
+    GFX_InitStruct->GFX_XOffset = 0;
+    GFX_InitStruct->GFX_YOffset = 0;
+    GFX_InitStruct->GFX_CSPort = 0;
+    GFX_InitStruct->GFX_CSPin = 0;
+    GFX_InitStruct->GFX_DCPort = 0;
+    GFX_InitStruct->GFX_DCPin = 0;
+    GFX_InitStruct->GFX_BaudRatePrescaler = SPI_BaudRatePrescaler_4;
+    GFX_InitStruct->GFX_Background = GFX_Black;
+    GFX_InitStruct->GFX_DrawCallback = 0;
+}
+
+/**
+ * @brief   Sends a controller command with optional parameters and waits
+ *        for it, for panel set-up. For the SSD1306 the parameters are
+ *        sent as command bytes.
+ * @param   Command - command byte.
+ *          Params - parameter bytes, must stay valid until sent.
+ *          Length - number of parameter bytes, 0 if none.
+ * @return  none
+ */
+void GFX_WriteCommand(uint8_t Command, const uint8_t *Params, uint8_t Length) {
+    static uint8_t cmd;
+
+    GFX_Wait();
+    cmd = Command;
+    if(GFX_Mono || (Length == 0)) {
+        GFX_Queue(&GFX_TrCmd[0], &cmd, 1, SPIBUS_Flag_None, 0);
+        if(Length != 0) {
+            GFX_Queue(&GFX_TrCmd[1], Params, Length, SPIBUS_Flag_None, 0);
+        }
+    }
+    else {
+        GFX_Queue(&GFX_TrCmd[0], &cmd, 1, SPIBUS_Flag_None, GFX_DCHigh);
+        GFX_Queue(&GFX_TrCmd[1], Params, Length, SPIBUS_Flag_None, GFX_DCLow);
+    }
+    while(SPIBUS_GetBusy() == SET)
+        ;
+}
+
+/**
+ * @brief   Marks the tiles covering a rectangle for redraw.
+ * @param   X, Y - top left corner.
+ *          Width, Height - size in pixels.
+ * @return  none
+ */
+void GFX_Invalidate(int16_t X, int16_t Y, int16_t Width, int16_t Height) {
+    int16_t  c0, c1, r0, r1, c;
+    uint16_t index;
+
+    if(X < 0) {
+        Width += X;
+        X = 0;
+    }
+    if(Y < 0) {
+        Height += Y;
+        Y = 0;
+    }
+    if((Width <= 0) || (Height <= 0)) {
+        return;
+    }
+
+    c0 = X / GFX_TileWidth;
+    c1 = (X + Width - 1) / GFX_TileWidth;
+    r0 = Y / GFX_TileHeight;
+    r1 = (Y + Height - 1) / GFX_TileHeight;
+    if(c1 >= GFX_Columns) {
+        c1 = GFX_Columns - 1;
+    }
+    if(r1 >= GFX_Rows) {
+        r1 = GFX_Rows - 1;
+    }
+
+    for(index = 0; r0 > 0; r0--, r1--) {
+        index += GFX_Columns;
+    }
+    for(; r1 >= 0; r1--, index += GFX_Columns) {
+        for(c = c0; c <= c1; c++) {
+            GFX_Dirty[(index + c) >> 3] |= (uint8_t)(1 << ((index + c) & 0x07));
+        }
+    }
+}
+
+/**
+ * @brief   Marks the whole screen for redraw.
+ * @return  none
+ */
+void GFX_InvalidateAll(void) {
+    GFX_Invalidate(0, 0, GFX_Columns * GFX_TileWidth, GFX_Rows * GFX_TileHeight);
+}
+
+/**
+ * @brief   Redraws and streams every dirty tile. Returns once the last
+ *        tile has been queued; GFX_Wait() waits for it to go out.
+ * @return  none
+ */
+void GFX_Render(void) {
+    uint16_t index = 0;
+    uint8_t  row, col, mask;
+
+    for(row = 0; row < GFX_Rows; row++) {
+        for(col = 0; col < GFX_Columns; col++, index++) {
+            mask = (uint8_t)(1 << (index & 0x07));
+            if(GFX_Dirty[index >> 3] & mask) {
+                GFX_Dirty[index >> 3] &= (uint8_t)~mask;
+                GFX_RenderTile(col, row);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Waits until both tile buffers have been streamed out.
+ * @return  none
+ */
+void GFX_Wait(void) {
+    GFX_WaitBuffer(0);
+    GFX_WaitBuffer(1);
+}
+
+/**
+ * @brief   Draws one pixel.
+ * @param   X, Y - pixel position.
+ *          Colour - RGB565 colour, or non-zero for lit on the SSD1306.
+ * @return  none
+ */
+void GFX_DrawPixel(int16_t X, int16_t Y, uint16_t Colour) {
+    if(((uint16_t)(X - GFX_TileX) < GFX_TileWidth) && ((uint16_t)(Y - GFX_TileY) < GFX_TileHeight)) {
+        GFX_Plot(X, Y, Colour);
+    }
+}
+
+/**
+ * @brief   Draws a filled rectangle.
+ * @param   X, Y - top left corner.
+ *          Width, Height - size in pixels.
+ *          Colour - fill colour.
+ * @return  none
+ */
+void GFX_FillRect(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint16_t Colour) {
+    int16_t x0 = X, y0 = Y, x1 = X + Width, y1 = Y + Height, x;
+
+    if(GFX_Touches(X, Y, Width, Height) != SET) {
+        return;
+    }
+    if(x0 < GFX_TileX) {
+        x0 = GFX_TileX;
+    }
+    if(y0 < GFX_TileY) {
+        y0 = GFX_TileY;
+    }
+    if(x1 > GFX_TileX + GFX_TileWidth) {
+        x1 = GFX_TileX + GFX_TileWidth;
+    }
+    if(y1 > GFX_TileY + GFX_TileHeight) {
+        y1 = GFX_TileY + GFX_TileHeight;
+    }
+    for(; y0 < y1; y0++) {
+        for(x = x0; x < x1; x++) {
+            GFX_Plot(x, y0, Colour);
+        }
+    }
+}
+
+/**
+ * @brief   Draws a one pixel wide rectangle outline.
+ * @param   X, Y - top left corner.
+ *          Width, Height - size in pixels.
+ *          Colour - line colour.
+ * @return  none
+ */
+void GFX_DrawRect(int16_t X, int16_t Y, int16_t Width, int16_t Height, uint16_t Colour) {
+    GFX_FillRect(X, Y, Width, 1, Colour);
+    GFX_FillRect(X, Y + Height - 1, Width, 1, Colour);
+    GFX_FillRect(X, Y, 1, Height, Colour);
+    GFX_FillRect(X + Width - 1, Y, 1, Height, Colour);
+}
+
+/**
+ * @brief   Draws a line with Bresenham's algorithm, skipped entirely when
+ *        its bounding box misses the current tile.
+ * @param   X0, Y0 - start point.
+ *          X1, Y1 - end point.
+ *          Colour - line colour.
+ * @return  none
+ */
+void GFX_DrawLine(int16_t X0, int16_t Y0, int16_t X1, int16_t Y1, uint16_t Colour) {
+    int16_t dx = (X1 > X0) ? (X1 - X0) : (X0 - X1);
+    int16_t dy = (Y1 > Y0) ? (Y0 - Y1) : (Y1 - Y0);
+    int16_t sx = (X1 > X0) ? 1 : -1;
+    int16_t sy = (Y1 > Y0) ? 1 : -1;
+    int16_t err = dx + dy, e2;
+
+    if(GFX_Touches((X0 < X1) ? X0 : X1, (Y0 < Y1) ? Y0 : Y1, dx + 1, 1 - dy) != SET) {
+        return;
+    }
+    while(1) {
+        GFX_DrawPixel(X0, Y0, Colour);
+        if((X0 == X1) && (Y0 == Y1)) {
+            break;
+        }
+        e2 = err << 1;
+        if(e2 >= dy) {
+            err += dy;
+            X0 += sx;
+        }
+        if(e2 <= dx) {
+            err += dx;
+            Y0 += sy;
+        }
+    }
+}
+
+/**
+ * @brief   Draws a monochrome bitmap; clear bits are transparent.
+ * @param   X, Y - top left corner.
+ *          Width, Height - size in pixels.
+ *          Bitmap - rows of (Width + 7) / 8 bytes, MSB first.
+ *          Colour - colour of set bits.
+ * @return  none
+ */
+void GFX_DrawBitmap(int16_t X, int16_t Y, int16_t Width, int16_t Height, const uint8_t *Bitmap, uint16_t Colour) {
+    int16_t x, y;
+    uint8_t stride = (uint8_t)((Width + 7) >> 3);
+
+    if(GFX_Touches(X, Y, Width, Height) != SET) {
+        return;
+    }
+    for(y = 0; y < Height; y++, Bitmap += stride) {
+        for(x = 0; x < Width; x++) {
+            if(Bitmap[x >> 3] & (0x80 >> (x & 0x07))) {
+                GFX_DrawPixel(X + x, Y + y, Colour);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Draws one character of the built-in 5x7 font; the background
+ *        is left untouched.
+ * @param   X, Y - top left corner of the character cell.
+ *          Char - printable ASCII character.
+ *          Colour - text colour.
+ * @return  none
+ */
+void GFX_DrawChar(int16_t X, int16_t Y, char Char, uint16_t Colour) {
+    const uint8_t *glyph;
+    uint8_t        col, row, bits;
+
+    if((Char < ' ') || (Char > '~') || (GFX_Touches(X, Y, 5, 7) != SET)) {
+        return;
+    }
+    glyph = GFX_Font[Char - ' '];
+    for(col = 0; col < 5; col++) {
+        bits = glyph[col];
+        for(row = 0; bits != 0; row++, bits >>= 1) {
+            if(bits & 0x01) {
+                GFX_DrawPixel(X + col, Y + row, Colour);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Draws a string; '\n' starts a new line below the first character.
+ * @param   X, Y - top left corner of the first character cell.
+ *          String - zero-terminated ASCII string.
+ *          Colour - text colour.
+ * @return  none
+ */
+void GFX_DrawString(int16_t X, int16_t Y, const char *String, uint16_t Colour) {
+    int16_t x = X;
+
+    /* Whole lines outside the tile only cost the loop */
+    for(; *String != '\0'; String++) {
+        if(*String == '\n') {
+            x = X;
+            Y += GFX_FontHeight;
+        }
+        else {
+            GFX_DrawChar(x, Y, *String, Colour);
+            x += GFX_FontWidth;
+        }
+    }
+}
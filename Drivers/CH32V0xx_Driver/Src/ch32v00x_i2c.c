@@ -79,6 +79,120 @@
 /* I2C Interrupt Enable mask */
 #define ITEN_Mask                ((uint32_t)0x07000000)
 
+/* RCC CFGR0 fields that change PCLK */
+#define CFGR0_CLOCK_Mask         ((uint32_t)(RCC_SWS | RCC_HPRE))
+
+/* I2C bus timing limits in ns for standard mode, fast mode and fast mode plus */
+static const uint16_t I2C_LowMin[3] = {4700, 1300, 500};
+static const uint16_t I2C_HighMin[3] = {4000, 600, 260};
+static const uint16_t I2C_RiseMax[3] = {1000, 300, 120};
+
+/* Requested SCL rate and duty, and the clock configuration CKCFGR was computed for */
+static uint32_t I2C_Speed = 0;
+static uint16_t I2C_Duty = I2C_DutyCycle_Auto;
+static uint32_t I2C_ClockConfig = 0;
+
+/**
+ * @brief   Returns the speed mode of an SCL rate.
+ * @param   Speed - SCL rate in Hz.
+ * @return  0 for standard mode, 1 for fast mode, 2 for fast mode plus.
+ */
+static uint8_t I2C_SpeedMode(uint32_t Speed) {
+    if(Speed <= 100000) {
+        return 0;
+    }
+    return (Speed <= 400000) ? 1 : 2;
+}
+
+/**
+ * @brief   Converts a duration to PCLK cycles, rounding up.
+ * @param   PCLK - peripheral clock in Hz.
+ *          Ns - duration in ns.
+ * @return  number of cycles.
+ */
+static uint32_t I2C_NsToCycles(uint32_t PCLK, uint16_t Ns) {
+    return ((PCLK / 1000) * Ns + 999999) / 1000000;
+}
+
+/**
+ * @brief   Computes CKCFGR for the fastest SCL rate not above Speed that
+ *        still meets the low and high period minimums of its mode. In
+ *        fast mode both duty cycles are tried unless one is requested.
+ * @param   PCLK - peripheral clock in Hz.
+ *          Speed - requested SCL rate in Hz.
+ *          DutyCycle - a value of @ref I2C_duty_cycle_in_fast_mode.
+ * @return  CKCFGR value.
+ */
+static uint16_t I2C_ComputeCKCFGR(uint32_t PCLK, uint32_t Speed, uint16_t DutyCycle) {
+    uint8_t  mode = I2C_SpeedMode(Speed);
+    uint32_t low = I2C_NsToCycles(PCLK, I2C_LowMin[mode]);
+    uint32_t high = I2C_NsToCycles(PCLK, I2C_HighMin[mode]);
+    uint32_t ccr2, ccr169;
+
+    if(mode == 0) {
+        /* Tlow = Thigh = CCR */
+        ccr2 = (PCLK + (Speed << 1) - 1) / (Speed << 1);
+        if(ccr2 < low) {
+            ccr2 = low;
+        }
+        if(ccr2 < 0x04) {
+            ccr2 = 0x04;
+        }
+        return (uint16_t)((ccr2 > CKCFGR_CCR_Set) ? CKCFGR_CCR_Set : ccr2);
+    }
+
+    /* Duty 2: Thigh = CCR, Tlow = 2 * CCR */
+    ccr2 = (PCLK + Speed * 3 - 1) / (Speed * 3);
+    if(ccr2 < high) {
+        ccr2 = high;
+    }
+    if((ccr2 << 1) < low) {
+        ccr2 = (low + 1) >> 1;
+    }
+
+    /* Duty 16/9: Thigh = 9 * CCR, Tlow = 16 * CCR */
+    ccr169 = (PCLK + Speed * 25 - 1) / (Speed * 25);
+    if(ccr169 * 9 < high) {
+        ccr169 = (high + 8) / 9;
+    }
+    if((ccr169 << 4) < low) {
+        ccr169 = (low + 15) >> 4;
+    }
+
+    if(DutyCycle == I2C_DutyCycle_Auto) {
+        DutyCycle = (ccr169 * 25 < ccr2 * 3) ? I2C_DutyCycle_16_9 : I2C_DutyCycle_2;
+    }
+    if(DutyCycle == I2C_DutyCycle_16_9) {
+        ccr2 = ccr169;
+    }
+    if(ccr2 == 0) {
+        ccr2 = 1;
+    }
+    if(ccr2 > CKCFGR_CCR_Set) {
+        ccr2 = CKCFGR_CCR_Set;
+    }
+    return (uint16_t)(ccr2 | CKCFGR_FS_Set | ((DutyCycle == I2C_DutyCycle_16_9) ? I2C_DutyCycle_16_9 : 0));
+}
+
+/**
+ * @brief   Programs FREQ and CKCFGR for the requested rate from the live
+ *        PCLK. The peripheral is left disabled.
+ * @param   I2Cx - where x can be 1 to select the I2C peripheral.
+ * @return  none
+ */
+static void I2C_SetClock(I2C_TypeDef *I2Cx) {
+    RCC_ClocksTypeDef rcc_clocks;
+    uint32_t          pclk1;
+
+    I2C_ClockConfig = RCC->CFGR0 & CFGR0_CLOCK_Mask;
+    RCC_GetClocksFreq(&rcc_clocks);
+    pclk1 = rcc_clocks.PCLK1_Frequency;
+
+    I2Cx->CTLR2 = (uint16_t)((I2Cx->CTLR2 & CTLR2_FREQ_Reset) | (pclk1 / 1000000));
+    I2Cx->CTLR1 &= CTLR1_PE_Reset;
+    I2Cx->CKCFGR = I2C_ComputeCKCFGR(pclk1, I2C_Speed, I2C_Duty);
+}
+
 /**
  * @brief   Deinitializes the I2Cx peripheral registers to their default
  *        reset values.
@@ -95,55 +209,21 @@ void I2C_DeInit(I2C_TypeDef *I2Cx) {
 /**
  * @brief   Initializes the I2Cx peripheral according to the specified
  *        parameters in the I2C_InitStruct.
+ *          The SCL timing is computed from the current PCLK: the closest
+ *        rate not above I2C_ClockSpeed that meets the bus minimums for
+ *        standard, fast or fast plus mode. I2C_GetTiming() reports it and
+ *        I2C_ClockUpdate() recomputes it after a clock change.
  * @param   I2Cx - where x can be 1 to select the I2C peripheral.
  *          I2C_InitStruct - pointer to a I2C_InitTypeDef structure that
  *        contains the configuration information for the specified I2C peripheral.
  * @return  none
  */
 void I2C_Init(I2C_TypeDef *I2Cx, I2C_InitTypeDef *I2C_InitStruct) {
-    uint16_t tmpreg = 0, freqrange = 0;
-    uint16_t result = 0x04;
-    uint32_t pclk1 = 8000000;
-
-    RCC_ClocksTypeDef rcc_clocks;
-
-    tmpreg = I2Cx->CTLR2;
-    tmpreg &= CTLR2_FREQ_Reset;
-    RCC_GetClocksFreq(&rcc_clocks);
-    pclk1 = rcc_clocks.PCLK1_Frequency;
-    freqrange = (uint16_t)(pclk1 / 1000000);
-    tmpreg |= freqrange;
-    I2Cx->CTLR2 = tmpreg;
-
-    I2Cx->CTLR1 &= CTLR1_PE_Reset;
-    tmpreg = 0;
-
-    if(I2C_InitStruct->I2C_ClockSpeed <= 100000) {
-        result = (uint16_t)(pclk1 / (I2C_InitStruct->I2C_ClockSpeed << 1));
-
-        if(result < 0x04) {
-            result = 0x04;
-        }
-
-        tmpreg |= result;
-    }
-    else {
-        if(I2C_InitStruct->I2C_DutyCycle == I2C_DutyCycle_2) {
-            result = (uint16_t)(pclk1 / (I2C_InitStruct->I2C_ClockSpeed * 3));
-        }
-        else {
-            result = (uint16_t)(pclk1 / (I2C_InitStruct->I2C_ClockSpeed * 25));
-            result |= I2C_DutyCycle_16_9;
-        }
-
-        if((result & CKCFGR_CCR_Set) == 0) {
-            result |= (uint16_t)0x0001;
-        }
-
-        tmpreg |= (uint16_t)(result | CKCFGR_FS_Set);
-    }
+    uint16_t tmpreg = 0;
 
-    I2Cx->CKCFGR = tmpreg;
+    I2C_Speed = I2C_InitStruct->I2C_ClockSpeed;
+    I2C_Duty = I2C_InitStruct->I2C_DutyCycle;
+    I2C_SetClock(I2Cx);
     I2Cx->CTLR1 |= CTLR1_PE_Set;
 
     tmpreg = I2Cx->CTLR1;
@@ -163,7 +243,7 @@ void I2C_Init(I2C_TypeDef *I2Cx, I2C_InitTypeDef *I2C_InitStruct) {
 void I2C_StructInit(I2C_InitTypeDef *I2C_InitStruct) {
     I2C_InitStruct->I2C_ClockSpeed = 5000;
     I2C_InitStruct->I2C_Mode = I2C_Mode_I2C;
-    I2C_InitStruct->I2C_DutyCycle = I2C_DutyCycle_2;
+    I2C_InitStruct->I2C_DutyCycle = I2C_DutyCycle_Auto;
     I2C_InitStruct->I2C_OwnAddress1 = 0;
     I2C_InitStruct->I2C_Ack = I2C_Ack_Disable;
     I2C_InitStruct->I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
@@ -748,3 +828,66 @@ void I2C_ClearITPendingBit(I2C_TypeDef *I2Cx, uint32_t I2C_IT) {
     flagpos = I2C_IT & FLAG_Mask;
     I2Cx->STAR1 = (uint16_t)~flagpos;
 }
+
+/**
+ * @brief   Reports the SCL timing currently programmed.
+ * @param   I2Cx - where x can be 1 to select the I2C peripheral.
+ *          I2C_Timing - pointer to a I2C_TimingTypeDef structure to fill.
+ * @return  none
+ */
+void I2C_GetTiming(I2C_TypeDef *I2Cx, I2C_TimingTypeDef *I2C_Timing) {
+    RCC_ClocksTypeDef rcc_clocks;
+    uint32_t          pclk1, low, high;
+    uint16_t          ckcfgr = I2Cx->CKCFGR;
+    uint16_t          ccr = ckcfgr & CKCFGR_CCR_Set;
+    uint8_t           mode = 0;
+
+    RCC_GetClocksFreq(&rcc_clocks);
+    pclk1 = rcc_clocks.PCLK1_Frequency;
+
+    if((ckcfgr & CKCFGR_FS_Set) == 0) {
+        low = ccr;
+        high = ccr;
+    }
+    else if(ckcfgr & I2C_DutyCycle_16_9) {
+        low = (uint32_t)ccr << 4;
+        high = (uint32_t)ccr * 9;
+    }
+    else {
+        low = (uint32_t)ccr << 1;
+        high = ccr;
+    }
+
+    I2C_Timing->I2C_ClockSpeed = (low + high != 0) ? (pclk1 / (low + high)) : 0;
+    if(ckcfgr & CKCFGR_FS_Set) {
+        mode = (I2C_Timing->I2C_ClockSpeed > 400000) ? 2 : 1;
+    }
+    I2C_Timing->I2C_LowTime = low * 10000 / (pclk1 / 100000);
+    I2C_Timing->I2C_HighTime = high * 10000 / (pclk1 / 100000);
+    I2C_Timing->I2C_RiseTime = I2C_RiseMax[mode];
+    I2C_Timing->I2C_SlowestClockSpeed = 1000000000 / (I2C_Timing->I2C_LowTime + I2C_Timing->I2C_HighTime +
+                                                      I2C_Timing->I2C_RiseTime);
+}
+
+/**
+ * @brief   Recomputes the SCL timing if the system clock source or AHB
+ *        prescaler changed since it was last computed. Cheap when nothing
+ *        changed, so it can be called before every transfer. The bus must
+ *        be idle.
+ * @param   I2Cx - where x can be 1 to select the I2C peripheral.
+ * @return  none
+ */
+void I2C_ClockUpdate(I2C_TypeDef *I2Cx) {
+    uint32_t timeout = 0x00010000;
+    uint16_t pe;
+
+    if((I2C_Speed == 0) || ((RCC->CFGR0 & CFGR0_CLOCK_Mask) == I2C_ClockConfig)) {
+        return;
+    }
+    /* Let a STOP still being generated finish before PE drops */
+    while((I2Cx->CTLR1 & CTLR1_STOP_Set) && (--timeout != 0))
+        ;
+    pe = I2Cx->CTLR1 & CTLR1_PE_Set;
+    I2C_SetClock(I2Cx);
+    I2Cx->CTLR1 |= pe;
+}
@@ -0,0 +1,674 @@
+#include "ch32v00x_i2cm.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_gpio.h"
+#include "ch32v00x_i2c.h"
+#include "ch32v00x_rcc.h"
+
+/* I2C1 DMA channels */
+#define I2CM_TX_DMA_Channel      DMA1_Channel6
+#define I2CM_RX_DMA_Channel      DMA1_Channel7
+
+/* Error flags cleared by the error handler */
+#define I2CM_ErrorFlags          ((uint16_t)(I2C_STAR1_BERR | I2C_STAR1_ARLO | I2C_STAR1_AF | I2C_STAR1_OVR | \
+                                             I2C_STAR1_PECERR | I2C_STAR1_TIMEOUT))
+
+/* Phases of the current direction: TXE, RXNE and BTF only count in DATA */
+#define I2CM_PHASE_START         ((uint8_t)0x00)
+#define I2CM_PHASE_ADDRESS       ((uint8_t)0x01)
+#define I2CM_PHASE_DATA          ((uint8_t)0x02)
+
+/* Busy-wait bound per byte of a blocking transfer */
+#define I2CM_ByteTimeout         ((uint32_t)0x00004000)
+
+/* Half SCL periods of the recovery clock per second (5 us), times the
+ * fewest cycles one delay loop takes, so HCLK / this is the loop count */
+#define I2CM_RecoveryLoopRate    ((uint32_t)(200000 * 4))
+
+/* Interrupts masked during an abort, all in the first NVIC word */
+#define I2CM_IRQMask             ((uint32_t)((1u << I2C1_EV_IRQn) | (1u << I2C1_ER_IRQn) | (1u << DMA1_Channel7_IRQn)))
+
+static I2CM_TransferTypeDef *volatile I2CM_Current = 0;
+static volatile uint16_t              I2CM_Watchdog = 0;
+
+static const uint8_t *I2CM_TxPtr = 0;
+static uint8_t       *I2CM_RxPtr = 0;
+static uint16_t       I2CM_TxCount = 0;
+static uint16_t       I2CM_RxCount = 0;
+static uint8_t        I2CM_Reading = 0;
+static uint8_t        I2CM_Phase = I2CM_PHASE_START;
+static uint8_t        I2CM_Dma = 0;
+static uint8_t        I2CM_Flags = 0;
+static uint8_t        I2CM_CountPending = 0;
+static uint8_t        I2CM_PECFailed = 0;
+static volatile uint8_t I2CM_Aborting = 0;
+
+/* ACK setting of the application, restored after each read */
+static uint16_t I2CM_Ack = 0;
+
+static I2CM_ErrorsTypeDef I2CM_Errors;
+
+/* Pins bit-banged by I2CM_Recover(), no port if not configured */
+static GPIO_TypeDef *I2CM_RecoveryGpio = 0;
+static uint16_t      I2CM_SCLPin = 0;
+static uint16_t      I2CM_SDAPin = 0;
+
+/**
+ * @brief   Sets the PEC bit when the transfer uses PEC: the byte in the
+ *        shift register (the next one with POS) is then sent or checked
+ *        as the PEC.
+ * @return  none
+ */
+static void I2CM_PEC(void) {
+    if(I2CM_Flags & I2CM_Flag_PEC) {
+        I2C_TransmitPEC(I2C1, ENABLE);
+    }
+}
+
+/**
+ * @brief   Increments an error counter, saturating at 0xFFFF.
+ * @param   Counter - counter to increment.
+ * @return  none
+ */
+static void I2CM_Count(uint16_t *Counter) {
+    if(*Counter != 0xFFFF) {
+        (*Counter)++;
+    }
+}
+
+/**
+ * @brief   Waits half a recovery clock period.
+ * @param   Loops - delay loops, scaled to HCLK by I2CM_Recover().
+ * @return  none
+ */
+static void I2CM_Delay(uint32_t Loops) {
+    volatile uint32_t i;
+
+    for(i = Loops; i != 0; i--)
+        ;
+}
+
+/**
+ * @brief   Ends the current transfer and runs its callback, which may
+ *        submit the next one.
+ * @param   Status - final @ref I2CM_status.
+ * @return  none
+ */
+static void I2CM_Finish(uint8_t Status) {
+    I2CM_TransferTypeDef *transfer = I2CM_Current;
+
+    I2C1->CTLR2 &= (uint16_t)~(I2C_CTLR2_ITBUFEN | I2C_CTLR2_DMAEN | I2C_CTLR2_LAST);
+    I2CM_TX_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+    I2CM_RX_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+    I2CM_Dma = 0;
+    I2C1->CTLR1 = (uint16_t)((I2C1->CTLR1 & ~(I2C_CTLR1_POS | I2C_CTLR1_ACK | I2C_CTLR1_PEC)) | I2CM_Ack);
+    I2CM_Current = 0;
+    transfer->I2CM_Status = Status;
+    if(transfer->I2CM_Callback != 0) {
+        transfer->I2CM_Callback(transfer);
+    }
+}
+
+/**
+ * @brief   Completes a read, failing it if the received PEC did not match.
+ * @return  none
+ */
+static void I2CM_ReadDone(void) {
+    if(I2C1->STAR1 & I2C_STAR1_PECERR) {
+        I2C1->STAR1 = (uint16_t)~I2C_STAR1_PECERR;
+        I2CM_Count(&I2CM_Errors.I2CM_PECError);
+        I2CM_PECFailed = 1;
+    }
+    I2CM_RxCount = 0;
+    I2CM_Finish(I2CM_PECFailed ? I2CM_Status_PECError : I2CM_Status_Done);
+}
+
+/**
+ * @brief   Takes the count byte of a block read and sets up the end of
+ *        the transfer from it, while the byte after it is on the bus.
+ * @param   Count - count byte received.
+ * @return  none
+ */
+static void I2CM_BlockCount(uint8_t Count) {
+    uint16_t pec = (I2CM_Flags & I2CM_Flag_PEC) ? 1 : 0;
+    uint16_t room = I2CM_Current->I2CM_RxLength - 1 - pec;
+
+    I2CM_CountPending = 0;
+    if(Count == 0) {
+        Count = 1;
+    }
+    if(Count > room) {
+        Count = (uint8_t)room;
+    }
+    I2CM_RxCount = Count + pec;
+    I2CM_Current->I2CM_Received = (uint16_t)(1 + I2CM_RxCount);
+
+    if(I2CM_RxCount == 3) {
+        I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+    }
+    else if(I2CM_RxCount == 2) {
+        /* With POS the NACK and PEC land on the byte after the one on the bus */
+        I2C1->CTLR1 = (uint16_t)((I2C1->CTLR1 & ~I2C_CTLR1_ACK) | I2C_CTLR1_POS);
+        I2CM_PEC();
+        I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+    }
+    else if(I2CM_RxCount == 1) {
+        I2C1->CTLR1 &= (uint16_t)~I2C_CTLR1_ACK;
+        I2CM_PEC();
+        I2C1->CTLR1 |= I2C_CTLR1_STOP;
+    }
+}
+
+/**
+ * @brief   Hands the remaining bytes of the current direction to DMA.
+ *          Called with ADDR still set, so the first request only comes
+ *        once ADDR is cleared. Reads set LAST so the peripheral NACKs the
+ *        final byte by itself.
+ * @param   Channel - I2CM_TX_DMA_Channel or I2CM_RX_DMA_Channel.
+ *          Buffer - memory side of the transfer.
+ *          Count - number of bytes.
+ * @return  none
+ */
+static void I2CM_StartDMA(DMA_Channel_TypeDef *Channel, uint8_t *Buffer, uint16_t Count) {
+    I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+    Channel->MADDR = (uint32_t)Buffer;
+    Channel->CNTR = Count;
+    Channel->CFGR |= DMA_CFGR1_EN;
+    if(Channel == I2CM_RX_DMA_Channel) {
+        I2C_DMALastTransferCmd(I2C1, ENABLE);
+    }
+    I2C_DMACmd(I2C1, ENABLE);
+    I2CM_Dma = 1;
+}
+
+/**
+ * @brief   Enables the I2C1 event and error interrupts for the master
+ *        state machine and prepares DMA1 channels 6 (TX) and 7 (RX) for
+ *        transfers of I2CM_DMAThreshold bytes or more.
+ *          Peripheral clocks, the SCL/SDA pins (alternate function open
+ *        drain), I2C_Init(), I2C_Cmd() and the I2C1_EV, I2C1_ER and
+ *        DMA1_Channel7 NVIC channels are configured by the application,
+ *        which calls I2CM_EV_IRQHandler() from I2C1_EV_IRQHandler(),
+ *        I2CM_ER_IRQHandler() from I2C1_ER_IRQHandler() and
+ *        I2CM_DMA_IRQHandler() from DMA1_Channel7_IRQHandler().
+ * @return  none
+ */
+void I2CM_Init(void) {
+    DMA_InitTypeDef DMA_InitStructure;
+
+    I2CM_Current = 0;
+    I2CM_Dma = 0;
+    I2CM_Watchdog = 0;
+    I2CM_ClearErrors();
+
+    DMA_DeInit(I2CM_TX_DMA_Channel);
+    DMA_DeInit(I2CM_RX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&I2C1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(I2CM_TX_DMA_Channel, &DMA_InitStructure);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_Init(I2CM_RX_DMA_Channel, &DMA_InitStructure);
+
+    /* Writes end on BTF; only reads need the DMA completion interrupt */
+    DMA_ITConfig(I2CM_RX_DMA_Channel, DMA_IT_TC, ENABLE);
+
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+}
+
+/**
+ * @brief   Starts a write, a read or a write followed by a read with a
+ *        repeated START, and returns at once. The interrupts do the rest.
+ *          With I2CM_Flag_PEC the hardware appends the PEC to a write
+ *        and checks it on a read; with I2CM_Flag_Block the first byte read
+ *        sets the read length (SMBus block read). Both run without DMA.
+ *          The SCL timing is recomputed first if the system clock has
+ *        changed. The transfer must stay valid until its status is no
+ *        longer I2CM_Status_Busy. Can be called from a completion callback.
+ * @param   Transfer - transfer to start.
+ * @return  READY if started, NoREADY if another transfer is running.
+ */
+ErrorStatus I2CM_Submit(I2CM_TransferTypeDef *Transfer) {
+    uint32_t mstatus;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    if(I2CM_Current != 0) {
+        __set_MSTATUS(mstatus);
+        return NoREADY;
+    }
+    I2CM_Current = Transfer;
+    __set_MSTATUS(mstatus);
+
+    Transfer->I2CM_Status = I2CM_Status_Busy;
+    Transfer->I2CM_Received = Transfer->I2CM_RxLength;
+    I2CM_Watchdog = (uint16_t)(I2CM_TimeoutTicks + ((Transfer->I2CM_TxLength + Transfer->I2CM_RxLength) >> 3));
+    I2CM_TxPtr = Transfer->I2CM_TxData;
+    I2CM_TxCount = Transfer->I2CM_TxLength;
+    I2CM_RxPtr = Transfer->I2CM_RxData;
+    I2CM_RxCount = Transfer->I2CM_RxLength;
+    I2CM_Reading = (I2CM_TxCount == 0) && (I2CM_RxCount != 0);
+    I2CM_Phase = I2CM_PHASE_START;
+    I2CM_Ack = I2C1->CTLR1 & I2C_CTLR1_ACK;
+    I2CM_Flags = Transfer->I2CM_Flags;
+    I2CM_PECFailed = 0;
+    I2CM_CountPending = 0;
+    if((I2CM_Flags & I2CM_Flag_Block) && (I2CM_RxCount >= 3)) {
+        /* Stay on the byte-by-byte path until the count byte is in */
+        I2CM_CountPending = 1;
+        I2CM_RxCount = 0xFFFF;
+    }
+    I2C_ClockUpdate(I2C1);
+
+    /* Toggling ENPEC clears the PEC register */
+    I2C_CalculatePEC(I2C1, DISABLE);
+    if(I2CM_Flags & I2CM_Flag_PEC) {
+        I2C_CalculatePEC(I2C1, ENABLE);
+    }
+
+    I2C1->CTLR2 |= I2C_CTLR2_ITBUFEN;
+    I2C1->CTLR1 |= I2C_CTLR1_START;
+    return READY;
+}
+
+/**
+ * @brief   Aborts a running transfer with I2CM_Status_Timeout. The bus
+ *        is recovered first, so a callback that submits the next transfer
+ *        finds a working peripheral. Only the I2C1 and DMA1 channel 7
+ *        interrupts are masked meanwhile; the recovery takes about 100 us
+ *        and other interrupts, such as a control loop, keep running.
+ *          Nothing happens if Transfer is no longer the running one or
+ *        another abort is under way, so I2CM_Tick() and a timed-out
+ *        I2CM_Transfer() never finish the same transfer twice.
+ * @param   Transfer - transfer to abort.
+ * @return  none
+ */
+static void I2CM_Abort(I2CM_TransferTypeDef *Transfer) {
+    uint32_t mstatus, enabled;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    if((Transfer == 0) || (I2CM_Current != Transfer) || I2CM_Aborting) {
+        __set_MSTATUS(mstatus);
+        return;
+    }
+    I2CM_Aborting = 1;
+    I2CM_Watchdog = 0;
+    enabled = NVIC->ISR[0] & I2CM_IRQMask;
+    NVIC->IRER[0] = I2CM_IRQMask;
+    __set_MSTATUS(mstatus);
+
+    I2CM_Count(&I2CM_Errors.I2CM_Timeout);
+    I2CM_Recover();
+    I2CM_Finish(I2CM_Status_Timeout);
+    I2CM_Aborting = 0;
+    NVIC->IENR[0] = enabled;
+}
+
+/**
+ * @brief   Runs a transfer and waits for it to finish, for at most a
+ *        busy-wait budget proportional to its length. A transfer that
+ *        overruns it is aborted and the bus recovered. Must not be called
+ *        from interrupt context.
+ * @param   Transfer - transfer to run.
+ * @return  final @ref I2CM_status, I2CM_Status_Idle if the engine was busy.
+ */
+uint8_t I2CM_Transfer(I2CM_TransferTypeDef *Transfer) {
+    uint32_t timeout = 0;
+    uint16_t bytes = Transfer->I2CM_TxLength + Transfer->I2CM_RxLength;
+
+    if(I2CM_Submit(Transfer) != READY) {
+        return I2CM_Status_Idle;
+    }
+    do {
+        timeout += I2CM_ByteTimeout;
+    } while(bytes-- != 0);
+
+    while(Transfer->I2CM_Status == I2CM_Status_Busy) {
+        if(--timeout == 0) {
+            I2CM_Abort(Transfer);
+            break;
+        }
+    }
+    return Transfer->I2CM_Status;
+}
+
+/**
+ * @brief   Checks whether a transfer is running.
+ * @return  SET while busy, RESET otherwise.
+ */
+FlagStatus I2CM_GetBusy(void) {
+    return (I2CM_Current != 0) ? SET : RESET;
+}
+
+/**
+ * @brief   Advances the master state machine on I2C1 events (SB, ADDR,
+ *        TXE, RXNE, BTF). Data flags only count once the ADDR of the
+ *        current direction is cleared: after a START request, including
+ *        one from a completion callback, they still reflect the last byte.
+ *          Reads follow the reference manual sequences: one byte clears
+ *        ACK before ADDR and sets STOP after it, two bytes use POS and
+ *        wait for BTF, longer reads stop taking RXNE interrupts three
+ *        bytes from the end so ACK and STOP land on the right bytes
+ *        while the clock is stretched.
+ * @return  none
+ */
+void I2CM_EV_IRQHandler(void) {
+    uint16_t sr1 = I2C1->STAR1;
+
+    if(I2CM_Current == 0) {
+        return;
+    }
+
+    if(sr1 & I2C_STAR1_SB) {
+        I2C1->DATAR = (uint8_t)((I2CM_Current->I2CM_Address << 1) | I2CM_Reading);
+        I2CM_Phase = I2CM_PHASE_ADDRESS;
+        return;
+    }
+
+    /* TXE and BTF of the last phase stay set until the new START is on the bus */
+    if(I2CM_Phase == I2CM_PHASE_START) {
+        return;
+    }
+
+    if(I2CM_Phase == I2CM_PHASE_ADDRESS) {
+        if((sr1 & I2C_STAR1_ADDR) == 0) {
+            return;
+        }
+        I2CM_Phase = I2CM_PHASE_DATA;
+        if(!I2CM_Reading) {
+            if((I2CM_TxCount >= I2CM_DMAThreshold) && (I2CM_Flags == 0)) {
+                I2CM_StartDMA(I2CM_TX_DMA_Channel, (uint8_t *)I2CM_TxPtr, I2CM_TxCount);
+                I2CM_TxCount = 0;
+            }
+            (void)I2C1->STAR2;
+            if((I2CM_TxCount == 0) && !I2CM_Dma) {
+                I2C1->CTLR1 |= I2C_CTLR1_STOP;
+                I2CM_Finish(I2CM_Status_Done);
+            }
+        }
+        else if((I2CM_RxCount >= I2CM_DMAThreshold) && (I2CM_Flags == 0)) {
+            I2CM_StartDMA(I2CM_RX_DMA_Channel, I2CM_RxPtr, I2CM_RxCount);
+            I2C1->CTLR1 |= I2C_CTLR1_ACK;
+            (void)I2C1->STAR2;
+        }
+        else if(I2CM_RxCount == 1) {
+            I2C1->CTLR1 &= (uint16_t)~I2C_CTLR1_ACK;
+            I2CM_PEC();
+            (void)I2C1->STAR2;
+            I2C1->CTLR1 |= I2C_CTLR1_STOP;
+        }
+        else if(I2CM_RxCount == 2) {
+            I2C1->CTLR1 = (uint16_t)((I2C1->CTLR1 & ~I2C_CTLR1_ACK) | I2C_CTLR1_POS);
+            I2CM_PEC();
+            (void)I2C1->STAR2;
+            I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+        }
+        else {
+            I2C1->CTLR1 |= I2C_CTLR1_ACK;
+            (void)I2C1->STAR2;
+        }
+        return;
+    }
+
+    if(I2CM_Reading) {
+        if(I2CM_Dma) {
+            /* Ends in I2CM_DMA_IRQHandler() */
+        }
+        else if(I2CM_RxCount > 3) {
+            if(sr1 & I2C_STAR1_RXNE) {
+                *I2CM_RxPtr = (uint8_t)I2C1->DATAR;
+                if(I2CM_CountPending) {
+                    I2CM_BlockCount(*I2CM_RxPtr++);
+                }
+                else if(I2CM_RxPtr++, --I2CM_RxCount == 3) {
+                    I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+                }
+            }
+        }
+        else if(I2CM_RxCount == 3) {
+            if(sr1 & I2C_STAR1_BTF) {
+                I2C1->CTLR1 &= (uint16_t)~I2C_CTLR1_ACK;
+                *I2CM_RxPtr++ = (uint8_t)I2C1->DATAR;
+                I2CM_PEC();
+                I2CM_RxCount = 2;
+            }
+        }
+        else if(I2CM_RxCount == 2) {
+            if(sr1 & I2C_STAR1_BTF) {
+                I2C1->CTLR1 |= I2C_CTLR1_STOP;
+                *I2CM_RxPtr++ = (uint8_t)I2C1->DATAR;
+                *I2CM_RxPtr++ = (uint8_t)I2C1->DATAR;
+                I2CM_ReadDone();
+            }
+        }
+        else if(sr1 & I2C_STAR1_RXNE) {
+            *I2CM_RxPtr++ = (uint8_t)I2C1->DATAR;
+            I2CM_ReadDone();
+        }
+        return;
+    }
+
+    if(I2CM_TxCount != 0) {
+        if(sr1 & (I2C_STAR1_TXE | I2C_STAR1_BTF)) {
+            I2C1->DATAR = *I2CM_TxPtr++;
+            if(--I2CM_TxCount == 0) {
+                /* Wait for BTF: the last byte must be on the bus before START or STOP */
+                I2C1->CTLR2 &= (uint16_t)~I2C_CTLR2_ITBUFEN;
+                if(I2CM_RxCount == 0) {
+                    I2CM_PEC();
+                }
+            }
+        }
+    }
+    else if(sr1 & I2C_STAR1_BTF) {
+        if(I2CM_Dma) {
+            if(I2CM_TX_DMA_Channel->CNTR != 0) {
+                return;
+            }
+            I2C_DMACmd(I2C1, DISABLE);
+            I2CM_TX_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+            I2CM_Dma = 0;
+        }
+        if(I2CM_RxCount != 0) {
+            I2CM_Reading = 1;
+            I2CM_Phase = I2CM_PHASE_START;
+            I2C1->CTLR2 |= I2C_CTLR2_ITBUFEN;
+            I2C1->CTLR1 |= I2C_CTLR1_START;
+        }
+        else {
+            I2C1->CTLR1 |= I2C_CTLR1_STOP;
+            I2CM_Finish(I2CM_Status_Done);
+        }
+    }
+}
+
+/**
+ * @brief   Handles I2C1 errors and counts each flag. A NACK ends the transfer with a STOP,
+ *        lost arbitration releases the bus, a bus error resets the
+ *        transfer with a STOP.
+ * @return  none
+ */
+void I2CM_ER_IRQHandler(void) {
+    uint16_t sr1 = I2C1->STAR1;
+
+    I2C1->STAR1 = (uint16_t)~(sr1 & I2CM_ErrorFlags);
+    if(sr1 & I2C_STAR1_BERR) {
+        I2CM_Count(&I2CM_Errors.I2CM_BusError);
+    }
+    if(sr1 & I2C_STAR1_ARLO) {
+        I2CM_Count(&I2CM_Errors.I2CM_ArbitrationLost);
+    }
+    if(sr1 & I2C_STAR1_AF) {
+        I2CM_Count(&I2CM_Errors.I2CM_AckFailure);
+    }
+    if(sr1 & I2C_STAR1_OVR) {
+        I2CM_Count(&I2CM_Errors.I2CM_Overrun);
+    }
+    if(sr1 & I2C_STAR1_PECERR) {
+        I2CM_Count(&I2CM_Errors.I2CM_PECError);
+        I2CM_PECFailed = 1;
+    }
+    if(I2CM_Current == 0) {
+        return;
+    }
+
+    if(sr1 & I2C_STAR1_AF) {
+        I2C1->CTLR1 |= I2C_CTLR1_STOP;
+        I2CM_Finish(I2CM_Status_Nack);
+    }
+    else if(sr1 & I2C_STAR1_ARLO) {
+        I2CM_Finish(I2CM_Status_Error);
+    }
+    else if(sr1 & I2C_STAR1_BERR) {
+        I2C1->CTLR1 |= I2C_CTLR1_STOP;
+        I2CM_Finish(I2CM_Status_Error);
+    }
+}
+
+/**
+ * @brief   Completes a DMA read: LAST has already NACKed the final byte,
+ *        so only the STOP is left. This is the single interrupt of a DMA
+ *        read, whatever its length.
+ * @return  none
+ */
+void I2CM_DMA_IRQHandler(void) {
+    if((DMA1->INTFR & DMA1_FLAG_TC7) == 0) {
+        return;
+    }
+    DMA1->INTFCR = DMA1_FLAG_GL7;
+    if((I2CM_Current == 0) || !I2CM_Dma) {
+        return;
+    }
+    I2C1->CTLR1 |= I2C_CTLR1_STOP;
+    I2CM_RxCount = 0;
+    I2CM_Finish(I2CM_Status_Done);
+}
+
+/**
+ * @brief   Watchdog for non-blocking transfers; call it every millisecond,
+ *        e.g. next to I2CQ_Tick(). A transfer still running after
+ *        I2CM_TimeoutTicks plus one tick per 8 bytes is aborted with
+ *        I2CM_Status_Timeout and the bus is recovered, so a slave
+ *        holding SDA low cannot stall the engine.
+ * @return  none
+ */
+void I2CM_Tick(void) {
+    if((I2CM_Current != 0) && !I2CM_Aborting && (I2CM_Watchdog != 0) && (--I2CM_Watchdog == 0)) {
+        I2CM_Abort(I2CM_Current);
+    }
+}
+
+/**
+ * @brief   Sets the pins I2CM_Recover() bit-bangs. Without them recovery
+ *        is limited to resetting the peripheral.
+ * @param   GPIOx - port of the I2C1 pins in use.
+ *          SCLPin - SCL pin.
+ *          SDAPin - SDA pin.
+ * @return  none
+ */
+void I2CM_RecoveryConfig(GPIO_TypeDef *GPIOx, uint16_t SCLPin, uint16_t SDAPin) {
+    I2CM_RecoveryGpio = GPIOx;
+    I2CM_SCLPin = SCLPin;
+    I2CM_SDAPin = SDAPin;
+}
+
+/**
+ * @brief   Frees a stuck bus: SCL is clocked up to nine times through GPIO
+ *        until the slave releases SDA, a STOP is generated, and the
+ *        peripheral is reset with I2C_SoftwareResetCmd() and its
+ *        configuration restored. The SCL half period is timed from HCLK
+ *        and is at least 5 us, so it takes about 100 us at any clock.
+ *          Timeouts call it automatically; otherwise it must not be
+ *        called while a transfer is running.
+ * @return  READY if SDA is high afterwards, NoREADY otherwise.
+ */
+ErrorStatus I2CM_Recover(void) {
+    GPIO_InitTypeDef  GPIO_InitStructure;
+    RCC_ClocksTypeDef RCC_ClocksStatus;
+    uint16_t          ctlr1, ctlr2, oaddr1, oaddr2, ckcfgr;
+    uint32_t          loops;
+    uint8_t           i;
+    ErrorStatus       status = READY;
+
+    I2CM_Count(&I2CM_Errors.I2CM_Recovery);
+    ctlr1 = I2C1->CTLR1 & (uint16_t)~(I2C_CTLR1_START | I2C_CTLR1_STOP | I2C_CTLR1_POS | I2C_CTLR1_PEC);
+    ctlr2 = I2C1->CTLR2 & (uint16_t)~(I2C_CTLR2_ITBUFEN | I2C_CTLR2_DMAEN | I2C_CTLR2_LAST);
+    oaddr1 = I2C1->OADDR1;
+    oaddr2 = I2C1->OADDR2;
+    ckcfgr = I2C1->CKCFGR;
+
+    if(I2CM_RecoveryGpio != 0) {
+        RCC_GetClocksFreq(&RCC_ClocksStatus);
+        loops = RCC_ClocksStatus.HCLK_Frequency / I2CM_RecoveryLoopRate;
+        I2C1->CTLR1 &= (uint16_t)~I2C_CTLR1_PE;
+        I2CM_RecoveryGpio->BSHR = I2CM_SCLPin | I2CM_SDAPin;
+        GPIO_InitStructure.GPIO_Pin = I2CM_SCLPin | I2CM_SDAPin;
+        GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
+        GPIO_Init(I2CM_RecoveryGpio, &GPIO_InitStructure);
+
+        for(i = 0; (i < 9) && ((I2CM_RecoveryGpio->INDR & I2CM_SDAPin) == 0); i++) {
+            I2CM_RecoveryGpio->BCR = I2CM_SCLPin;
+            I2CM_Delay(loops);
+            I2CM_RecoveryGpio->BSHR = I2CM_SCLPin;
+            I2CM_Delay(loops);
+        }
+
+        /* STOP: SDA rises while SCL is high */
+        I2CM_RecoveryGpio->BCR = I2CM_SCLPin;
+        I2CM_Delay(loops);
+        I2CM_RecoveryGpio->BCR = I2CM_SDAPin;
+        I2CM_Delay(loops);
+        I2CM_RecoveryGpio->BSHR = I2CM_SCLPin;
+        I2CM_Delay(loops);
+        I2CM_RecoveryGpio->BSHR = I2CM_SDAPin;
+        I2CM_Delay(loops);
+        if((I2CM_RecoveryGpio->INDR & I2CM_SDAPin) == 0) {
+            status = NoREADY;
+        }
+
+        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+        GPIO_Init(I2CM_RecoveryGpio, &GPIO_InitStructure);
+    }
+
+    I2C_SoftwareResetCmd(I2C1, ENABLE);
+    I2C_SoftwareResetCmd(I2C1, DISABLE);
+    I2C1->CTLR2 = ctlr2;
+    I2C1->OADDR1 = oaddr1;
+    I2C1->OADDR2 = oaddr2;
+    I2C1->CKCFGR = ckcfgr;
+    I2C1->CTLR1 = ctlr1;
+
+    return status;
+}
+
+/**
+ * @brief   Copies the error counters.
+ * @param   Errors - pointer to a I2CM_ErrorsTypeDef structure to fill.
+ * @return  none
+ */
+void I2CM_GetErrors(I2CM_ErrorsTypeDef *Errors) {
+    *Errors = I2CM_Errors;
+}
+
+/**
+ * @brief   Clears the error counters.
+ * @return  none
+ */
+void I2CM_ClearErrors(void) {
+    I2CM_Errors.I2CM_BusError = 0;
+    I2CM_Errors.I2CM_ArbitrationLost = 0;
+    I2CM_Errors.I2CM_AckFailure = 0;
+    I2CM_Errors.I2CM_Overrun = 0;
+    I2CM_Errors.I2CM_PECError = 0;
+    I2CM_Errors.I2CM_Timeout = 0;
+    I2CM_Errors.I2CM_Recovery = 0;
+}
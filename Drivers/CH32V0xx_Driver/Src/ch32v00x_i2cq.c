@@ -0,0 +1,193 @@
+#include "ch32v00x_i2cq.h"
+
+static I2CQ_JobTypeDef *I2CQ_Jobs = 0;
+static I2CQ_JobTypeDef *volatile I2CQ_Running = 0;
+
+/**
+ * @brief   Unlinks a job from the job list. Interrupts must be disabled.
+ * @param   Job - job to unlink.
+ * @return  none
+ */
+static void I2CQ_Unlink(I2CQ_JobTypeDef *Job) {
+    I2CQ_JobTypeDef **link = &I2CQ_Jobs;
+
+    while(*link != 0) {
+        if(*link == Job) {
+            *link = Job->I2CQ_Next;
+            break;
+        }
+        link = &(*link)->I2CQ_Next;
+    }
+    Job->I2CQ_Pending = 0;
+}
+
+static void I2CQ_Done(I2CM_TransferTypeDef *Transfer);
+
+/**
+ * @brief   Starts the most urgent pending job if the bus is free.
+ *        Interrupts must be disabled or the caller must be the I2C
+ *        completion interrupt.
+ * @return  none
+ */
+static void I2CQ_Dispatch(void) {
+    I2CQ_JobTypeDef *job, *best = 0;
+
+    if(I2CQ_Running != 0) {
+        return;
+    }
+    for(job = I2CQ_Jobs; job != 0; job = job->I2CQ_Next) {
+        if(job->I2CQ_Pending && ((best == 0) || (job->I2CQ_Priority < best->I2CQ_Priority))) {
+            best = job;
+        }
+    }
+    if(best == 0) {
+        return;
+    }
+
+    best->I2CQ_Transfer.I2CM_Callback = I2CQ_Done;
+    if(I2CM_Submit(&best->I2CQ_Transfer) == READY) {
+        best->I2CQ_Pending = 0;
+        I2CQ_Running = best;
+    }
+}
+
+/**
+ * @brief   I2CM completion callback: retires one-shot jobs, reports the
+ *        job and immediately starts the next pending one so the bus does
+ *        not sit idle between jobs.
+ * @param   Transfer - the finished transfer, first member of its job.
+ * @return  none
+ */
+static void I2CQ_Done(I2CM_TransferTypeDef *Transfer) {
+    I2CQ_JobTypeDef *job = (I2CQ_JobTypeDef *)Transfer;
+    uint32_t         mstatus;
+
+    /* A nested timer interrupt may call I2CQ_Tick() */
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    I2CQ_Running = 0;
+    if(job->I2CQ_Period == 0) {
+        I2CQ_Unlink(job);
+    }
+    __set_MSTATUS(mstatus);
+
+    /* Unlinked first so a one-shot job can add itself again */
+    if(job->I2CQ_Callback != 0) {
+        job->I2CQ_Callback(job);
+    }
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    I2CQ_Dispatch();
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Initializes the I2C transaction scheduler on top of the I2CM
+ *        engine, which must already be initialized. The scheduler owns
+ *        I2CM while jobs are queued; transfers submitted directly are
+ *        only possible while I2CQ_GetBusy() is RESET.
+ * @return  none
+ */
+void I2CQ_Init(void) {
+    I2CQ_Jobs = 0;
+    I2CQ_Running = 0;
+}
+
+/**
+ * @brief   Adds a job. One-shot jobs run as soon as the bus allows and
+ *        are removed afterwards. Periodic jobs run first on the next
+ *        I2CQ_Tick(), so all jobs added together poll in the same tick
+ *        and stay aligned when their periods are multiples of each other.
+ *          The job must stay valid until removed. Can be called from
+ *        interrupt context, including a job callback.
+ * @param   Job - job to add.
+ * @return  READY if added, NoREADY if it is already queued.
+ */
+ErrorStatus I2CQ_Add(I2CQ_JobTypeDef *Job) {
+    I2CQ_JobTypeDef *job;
+    uint32_t         mstatus;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    for(job = I2CQ_Jobs; job != 0; job = job->I2CQ_Next) {
+        if(job == Job) {
+            __set_MSTATUS(mstatus);
+            return NoREADY;
+        }
+    }
+    Job->I2CQ_Overruns = 0;
+    Job->I2CQ_Countdown = 1;
+    Job->I2CQ_Pending = (Job->I2CQ_Period == 0);
+    Job->I2CQ_Next = I2CQ_Jobs;
+    I2CQ_Jobs = Job;
+    I2CQ_Dispatch();
+    __set_MSTATUS(mstatus);
+
+    return READY;
+}
+
+/**
+ * @brief   Removes a job. A run already on the bus still completes and
+ *        calls the callback, so the job memory may only be reused once
+ *        its I2CM_Status is no longer I2CM_Status_Busy.
+ * @param   Job - job to remove.
+ * @return  none
+ */
+void I2CQ_Remove(I2CQ_JobTypeDef *Job) {
+    uint32_t mstatus;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    I2CQ_Unlink(Job);
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Advances the poll timers; call it at a fixed rate, e.g. from
+ *        a 1 ms timer interrupt. Every job due in this tick is marked
+ *        pending at once and the whole batch runs back to back in
+ *        priority order. A job that is still pending from its previous
+ *        poll is not queued twice; the merged poll is counted in
+ *        I2CQ_Overruns.
+ * @return  none
+ */
+void I2CQ_Tick(void) {
+    I2CQ_JobTypeDef *job;
+    uint32_t         mstatus;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    for(job = I2CQ_Jobs; job != 0; job = job->I2CQ_Next) {
+        if((job->I2CQ_Period == 0) || (--job->I2CQ_Countdown != 0)) {
+            continue;
+        }
+        job->I2CQ_Countdown = job->I2CQ_Period;
+        if(job->I2CQ_Pending || (job == I2CQ_Running)) {
+            job->I2CQ_Overruns++;
+        }
+        else {
+            job->I2CQ_Pending = 1;
+        }
+    }
+    I2CQ_Dispatch();
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Checks whether a job is on the bus or waiting for it.
+ * @return  SET if busy, RESET otherwise.
+ */
+FlagStatus I2CQ_GetBusy(void) {
+    I2CQ_JobTypeDef *job;
+
+    if(I2CQ_Running != 0) {
+        return SET;
+    }
+    for(job = I2CQ_Jobs; job != 0; job = job->I2CQ_Next) {
+        if(job->I2CQ_Pending) {
+            return SET;
+        }
+    }
+    return RESET;
+}
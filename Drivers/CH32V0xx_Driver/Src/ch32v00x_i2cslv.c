@@ -0,0 +1,206 @@
+#include "ch32v00x_i2cslv.h"
+#include "ch32v00x_i2c.h"
+
+/* Error flags cleared by the error handler */
+#define I2CSLV_ErrorFlags        ((uint16_t)(I2C_STAR1_BERR | I2C_STAR1_ARLO | I2C_STAR1_AF | I2C_STAR1_OVR))
+
+/* Entries per map, one bit each in I2CSLV_Read and I2CSLV_Written */
+#define I2CSLV_MaxEntries        32
+
+static const I2CSLV_RegisterTypeDef *I2CSLV_Maps[2];
+static uint8_t                       I2CSLV_MapSizes[2];
+
+/* Transaction state: map in use, register pointer, first byte flag and touched entries */
+static const I2CSLV_RegisterTypeDef *I2CSLV_Map = 0;
+static uint8_t                       I2CSLV_MapSize = 0;
+static uint8_t                       I2CSLV_Pointer = 0;
+static uint8_t                       I2CSLV_First = 0;
+static uint32_t                      I2CSLV_Read = 0;
+static uint32_t                      I2CSLV_Written = 0;
+
+/**
+ * @brief   Finds the map entry holding the register at the pointer.
+ * @param   Index - receives the entry index.
+ * @return  the entry, 0 if the register is unmapped.
+ */
+static const I2CSLV_RegisterTypeDef *I2CSLV_Find(uint8_t *Index) {
+    const I2CSLV_RegisterTypeDef *reg = I2CSLV_Map;
+    uint8_t                       i;
+
+    for(i = 0; i < I2CSLV_MapSize; i++, reg++) {
+        if((uint8_t)(I2CSLV_Pointer - reg->I2CSLV_Address) < reg->I2CSLV_Size) {
+            *Index = i;
+            return reg;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief   Ends a transaction: runs the callbacks of every entry read or
+ *        written. The bus is already released, so they never stretch it.
+ * @return  none
+ */
+static void I2CSLV_End(void) {
+    const I2CSLV_RegisterTypeDef *reg = I2CSLV_Map;
+    uint32_t                      read = I2CSLV_Read;
+    uint32_t                      written = I2CSLV_Written;
+
+    I2CSLV_Read = 0;
+    I2CSLV_Written = 0;
+    for(; (read | written) != 0; reg++, read >>= 1, written >>= 1) {
+        if(reg->I2CSLV_Callback == 0) {
+            continue;
+        }
+        if(written & 0x01) {
+            reg->I2CSLV_Callback(reg, I2CSLV_Event_Write);
+        }
+        if(read & 0x01) {
+            reg->I2CSLV_Callback(reg, I2CSLV_Event_Read);
+        }
+    }
+}
+
+/**
+ * @brief   Initializes I2C1 as a register-map slave: the master writes a
+ *        register pointer and then streams bytes to or from consecutive
+ *        registers, across map entries. Unmapped registers read as
+ *        I2CSLV_FillByte and ignore writes.
+ *          A second address with its own map is served through
+ *        I2C_OwnAddress2Config() and I2C_DualAddressCmd().
+ *          Every byte is served from RAM inside the event interrupt, so
+ *        clock stretching (I2C_StretchClockCmd()) is bounded by the
+ *        interrupt latency. Register callbacks only run after the master
+ *        has released the bus; the application keeps the register
+ *        storage up to date instead of producing data on demand.
+ *          Peripheral clocks, the SCL/SDA pins (alternate function open
+ *        drain) and the I2C1_EV/I2C1_ER NVIC channels are configured by
+ *        the application, which calls I2CSLV_EV_IRQHandler() from
+ *        I2C1_EV_IRQHandler() and I2CSLV_ER_IRQHandler() from
+ *        I2C1_ER_IRQHandler().
+ * @param   I2CSLV_InitStruct - pointer to a I2CSLV_InitTypeDef structure.
+ * @return  none
+ */
+void I2CSLV_Init(I2CSLV_InitTypeDef *I2CSLV_InitStruct) {
+    I2C_InitTypeDef I2C_InitStructure;
+
+    I2CSLV_Maps[0] = I2CSLV_InitStruct->I2CSLV_Map1;
+    I2CSLV_MapSizes[0] = I2CSLV_InitStruct->I2CSLV_Map1Size;
+    if(I2CSLV_MapSizes[0] > I2CSLV_MaxEntries) {
+        I2CSLV_MapSizes[0] = I2CSLV_MaxEntries;
+    }
+    I2CSLV_Maps[1] = I2CSLV_InitStruct->I2CSLV_Map2;
+    I2CSLV_MapSizes[1] = I2CSLV_InitStruct->I2CSLV_Map2Size;
+    if(I2CSLV_MapSizes[1] > I2CSLV_MaxEntries) {
+        I2CSLV_MapSizes[1] = I2CSLV_MaxEntries;
+    }
+    I2CSLV_Map = I2CSLV_Maps[0];
+    I2CSLV_MapSize = I2CSLV_MapSizes[0];
+    I2CSLV_Pointer = 0;
+    I2CSLV_Read = 0;
+    I2CSLV_Written = 0;
+
+    /* The clock setting only matters for the timing of the data setup */
+    I2C_InitStructure.I2C_ClockSpeed = 400000;
+    I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+    I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+    I2C_InitStructure.I2C_OwnAddress1 = (uint16_t)(I2CSLV_InitStruct->I2CSLV_Address1 << 1);
+    I2C_InitStructure.I2C_Ack = I2C_Ack_Enable;
+    I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+    I2C_Init(I2C1, &I2C_InitStructure);
+
+    if(I2CSLV_InitStruct->I2CSLV_Address2 != 0) {
+        I2C_OwnAddress2Config(I2C1, (uint8_t)(I2CSLV_InitStruct->I2CSLV_Address2 << 1));
+        I2C_DualAddressCmd(I2C1, ENABLE);
+    }
+    else {
+        I2C_DualAddressCmd(I2C1, DISABLE);
+    }
+    I2C_StretchClockCmd(I2C1, I2CSLV_InitStruct->I2CSLV_Stretch);
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, ENABLE);
+    I2C_Cmd(I2C1, ENABLE);
+}
+
+/**
+ * @brief   Fills each I2CSLV_InitStruct member with its default value.
+ * @param   I2CSLV_InitStruct - pointer to a I2CSLV_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void I2CSLV_StructInit(I2CSLV_InitTypeDef *I2CSLV_InitStruct) {
+    I2CSLV_InitStruct->I2CSLV_Address1 = 0x28;
+    I2CSLV_InitStruct->I2CSLV_Map1 = 0;
+    I2CSLV_InitStruct->I2CSLV_Map1Size = 0;
+    I2CSLV_InitStruct->I2CSLV_Address2 = 0;
+    I2CSLV_InitStruct->I2CSLV_Map2 = 0;
+    I2CSLV_InitStruct->I2CSLV_Map2Size = 0;
+    I2CSLV_InitStruct->I2CSLV_Stretch = ENABLE;
+}
+
+/**
+ * @brief   Serves I2C1 slave events: address match, received bytes,
+ *        bytes to send and STOP.
+ * @return  none
+ */
+void I2CSLV_EV_IRQHandler(void) {
+    const I2CSLV_RegisterTypeDef *reg;
+    uint16_t                      sr1 = I2C1->STAR1;
+    uint16_t                      sr2;
+    uint8_t                       index, data;
+
+    if(sr1 & I2C_STAR1_ADDR) {
+        sr2 = I2C1->STAR2;
+        index = (sr2 & I2C_STAR2_DUALF) ? 1 : 0;
+        I2CSLV_Map = I2CSLV_Maps[index];
+        I2CSLV_MapSize = I2CSLV_MapSizes[index];
+        I2CSLV_First = (sr2 & I2C_STAR2_TRA) ? 0 : 1;
+    }
+
+    if(sr1 & I2C_STAR1_RXNE) {
+        data = (uint8_t)I2C1->DATAR;
+        if(I2CSLV_First) {
+            I2CSLV_Pointer = data;
+            I2CSLV_First = 0;
+        }
+        else {
+            reg = I2CSLV_Find(&index);
+            if((reg != 0) && (reg->I2CSLV_Access & I2CSLV_Access_Write)) {
+                reg->I2CSLV_Data[(uint8_t)(I2CSLV_Pointer - reg->I2CSLV_Address)] = data;
+                I2CSLV_Written |= (uint32_t)1 << index;
+            }
+            I2CSLV_Pointer++;
+        }
+    }
+    else if(sr1 & I2C_STAR1_TXE) {
+        data = I2CSLV_FillByte;
+        reg = I2CSLV_Find(&index);
+        if((reg != 0) && (reg->I2CSLV_Access & I2CSLV_Access_Read)) {
+            data = reg->I2CSLV_Data[(uint8_t)(I2CSLV_Pointer - reg->I2CSLV_Address)];
+            I2CSLV_Read |= (uint32_t)1 << index;
+        }
+        I2C1->DATAR = data;
+        I2CSLV_Pointer++;
+    }
+
+    if(sr1 & I2C_STAR1_STOPF) {
+        /* STOPF clears on a CTLR1 write after the STAR1 read */
+        I2C1->CTLR1 |= I2C_CTLR1_PE;
+        I2CSLV_End();
+    }
+}
+
+/**
+ * @brief   Handles I2C1 slave errors. The master ends every read with a
+ *        NACK, which also ends the transaction: the byte preloaded for
+ *        it was never sent, so the pointer steps back over it.
+ * @return  none
+ */
+void I2CSLV_ER_IRQHandler(void) {
+    uint16_t sr1 = I2C1->STAR1;
+
+    I2C1->STAR1 = (uint16_t)~(sr1 & I2CSLV_ErrorFlags);
+    if(sr1 & I2C_STAR1_AF) {
+        I2CSLV_Pointer--;
+    }
+    I2CSLV_End();
+}
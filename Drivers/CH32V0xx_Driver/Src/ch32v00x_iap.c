@@ -0,0 +1,278 @@
+#include "ch32v00x_iap.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_flash.h"
+#include "ch32v00x_frame.h"
+#include "ch32v00x_rcc.h"
+#include "ch32v00x_usart.h"
+
+/* USART1 RX DMA channel */
+#define IAP_RX_DMA_Channel       DMA1_Channel5
+
+/* Words in one fast programming page */
+#define IAP_PageWords            (IAP_PageSize / 4)
+
+/* End of the user flash area */
+#define IAP_FlashEnd             (FLASH_BASE + 0x4000)
+
+/* Boot area, mapped at 0 instead of the user area when FLASH_STATR BOOT_MODE is set */
+#define IAP_BootBase             ((uint32_t)0x1FFFF000)
+
+/* Header: sync, sync, page count (LE), image CRC (BE) */
+#define IAP_HeaderSize           6
+
+/* Flash extent of the running program, from the link script */
+extern uint8_t _sinit[], _data_lma[], _data_vma[], _edata[];
+
+/* Two page buffers filled back to back by the circular RX DMA */
+static uint32_t IAP_Buf[2 * IAP_PageWords];
+
+static uint32_t IAP_Base = FLASH_BASE;
+static uint32_t IAP_TimeoutTicks = 0;
+
+static void IAP_SendByte(uint8_t Data) {
+    while((USART1->STATR & USART_STATR_TXE) == 0)
+        ;
+    USART1->DATAR = Data;
+}
+
+/**
+ * @brief   Waits for a received byte.
+ * @param   Data - receives the byte.
+ * @return  READY if a byte arrived in time, NoREADY on timeout.
+ */
+static ErrorStatus IAP_ReceiveByte(uint8_t *Data) {
+    uint32_t start = SysTick->CNT;
+
+    while((USART1->STATR & USART_STATR_RXNE) == 0) {
+        if((SysTick->CNT - start) > IAP_TimeoutTicks) {
+            return NoREADY;
+        }
+    }
+    *Data = (uint8_t)USART1->DATAR;
+    return READY;
+}
+
+/**
+ * @brief   Checks that a flash range does not overlap the running program.
+ *        A program linked to the alias at 0 runs from whichever area the
+ *        alias maps, read from the boot mode in FLASH_STATR: the boot area
+ *        after a start from boot, the user area otherwise.
+ * @param   Start - first address of the range.
+ *          End - address after the range.
+ * @return  READY if the range is free, NoREADY otherwise.
+ */
+static ErrorStatus IAP_CheckRange(uint32_t Start, uint32_t End) {
+    uint32_t start = (uint32_t)_sinit;
+    uint32_t end = (uint32_t)_data_lma + (uint32_t)(_edata - _data_vma);
+    uint32_t alias;
+
+    if(start < FLASH_BASE) {
+        alias = ((FLASH->STATR & Start_Mode_BOOT) != 0) ? IAP_BootBase : FLASH_BASE;
+        start += alias;
+        end += alias;
+    }
+    return ((Start < end) && (End > start)) ? NoREADY : READY;
+}
+
+/**
+ * @brief   Erases and programs one 64-byte page with the fast page
+ *        programming sequence, then compares it with the source.
+ * @param   Address - page address.
+ *          Data - 16 words to program.
+ * @return  READY if the page reads back correctly, NoREADY otherwise.
+ */
+static ErrorStatus IAP_ProgramPage(uint32_t Address, const uint32_t *Data) {
+    uint8_t i;
+
+    FLASH_ErasePage_Fast(Address);
+    FLASH_BufReset();
+    for(i = 0; i < IAP_PageWords; i++) {
+        FLASH_BufLoad(Address + (i << 2), Data[i]);
+    }
+    FLASH_ProgramPage_Fast(Address);
+
+    for(i = 0; i < IAP_PageWords; i++) {
+        if(((__IO uint32_t *)Address)[i] != Data[i]) {
+            return NoREADY;
+        }
+    }
+    return READY;
+}
+
+/**
+ * @brief   Initializes USART1 and DMA1 channel 5 for the download link
+ *        according to the specified parameters in the IAP_InitStruct.
+ *          SysTick is taken over as a free-running HCLK/8 timebase for
+ *        the link timeouts.
+ *          Peripheral clocks and USART1 pins must be configured by the
+ *        application.
+ * @param   IAP_InitStruct - pointer to a IAP_InitTypeDef structure.
+ * @return  none
+ */
+void IAP_Init(IAP_InitTypeDef *IAP_InitStruct) {
+    USART_InitTypeDef USART_InitStructure;
+    DMA_InitTypeDef   DMA_InitStructure;
+    RCC_ClocksTypeDef RCC_ClocksStatus;
+
+    IAP_Base = IAP_InitStruct->IAP_Address & ~(uint32_t)(IAP_PageSize - 1);
+
+    RCC_GetClocksFreq(&RCC_ClocksStatus);
+    IAP_TimeoutTicks = (RCC_ClocksStatus.HCLK_Frequency / 8000) * IAP_InitStruct->IAP_Timeout;
+    SysTick->CTLR = 0;
+    SysTick->CNT = 0;
+    SysTick->CTLR = 1;
+
+    USART_StructInit(&USART_InitStructure);
+    USART_InitStructure.USART_BaudRate = IAP_InitStruct->IAP_BaudRate;
+    USART_Init(USART1, &USART_InitStructure);
+
+    DMA_DeInit(IAP_RX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)IAP_Buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = sizeof(IAP_Buf);
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(IAP_RX_DMA_Channel, &DMA_InitStructure);
+
+    USART_Cmd(USART1, ENABLE);
+}
+
+/**
+ * @brief   Fills each IAP_InitStruct member with its default value.
+ * @param   IAP_InitStruct - pointer to a IAP_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void IAP_StructInit(IAP_InitTypeDef *IAP_InitStruct) {
+    IAP_InitStruct->IAP_BaudRate = 115200;
+    IAP_InitStruct->IAP_Address = FLASH_BASE;
+    IAP_InitStruct->IAP_Timeout = 1000;
+}
+
+/**
+ * @brief   Receives an image over USART1 and writes it to flash.
+ *          The host sends a 6-byte header: IAP_Sync0, IAP_Sync1, the page
+ *        count (little endian) and the CRC-16/CCITT-FALSE of the padded
+ *        image (big endian), answered with IAP_ACK or IAP_NAK. It then
+ *        streams 64-byte pages, keeping at most two unacknowledged. The
+ *        RX DMA fills one half of a circular buffer while the other half
+ *        is being programmed, and every page is acknowledged once it has
+ *        been programmed and read back. After the last page the CRC is
+ *        recomputed over flash and answered with IAP_ACK or IAP_NAK.
+ *          A header whose image would overlap the running program is
+ *        answered with IAP_NAK before anything is erased.
+ * @return  a value of @ref IAP_status.
+ */
+uint8_t IAP_Download(void) {
+    uint8_t  header[IAP_HeaderSize];
+    uint16_t pages, page, crc, check, i;
+    uint32_t address, start, flag;
+    uint8_t  status = IAP_Status_OK;
+
+    /* Hunt for the sync pair, then take the rest of the header */
+    i = 0;
+    while(i < IAP_HeaderSize) {
+        if(IAP_ReceiveByte(&header[i]) != READY) {
+            return IAP_Status_Timeout;
+        }
+        if((i == 0) && (header[0] != IAP_Sync0)) {
+            continue;
+        }
+        if((i == 1) && (header[1] != IAP_Sync1)) {
+            i = (header[1] == IAP_Sync0) ? 1 : 0;
+            continue;
+        }
+        i++;
+    }
+    pages = (uint16_t)(header[2] | (header[3] << 8));
+    crc = (uint16_t)((header[4] << 8) | header[5]);
+    if((pages == 0) || (pages > ((IAP_FlashEnd - IAP_Base) / IAP_PageSize))) {
+        IAP_SendByte(IAP_NAK);
+        return IAP_Status_HeaderError;
+    }
+    if(IAP_CheckRange(IAP_Base, IAP_Base + ((uint32_t)pages * IAP_PageSize)) != READY) {
+        IAP_SendByte(IAP_NAK);
+        return IAP_Status_AddressError;
+    }
+
+    /* Arm the double buffer before acknowledging so the first page cannot be missed */
+    IAP_RX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    IAP_RX_DMA_Channel->CNTR = sizeof(IAP_Buf);
+    DMA1->INTFCR = DMA1_FLAG_GL5;
+    (void)USART1->DATAR;
+    USART_DMACmd(USART1, USART_DMAReq_Rx, ENABLE);
+    IAP_RX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+    FLASH_Unlock_Fast();
+    IAP_SendByte(IAP_ACK);
+
+    address = IAP_Base;
+    for(page = 0; page < pages; page++) {
+        flag = (page & 0x01) ? DMA1_FLAG_TC5 : DMA1_FLAG_HT5;
+        start = SysTick->CNT;
+        while((DMA1->INTFR & flag) == 0) {
+            if((SysTick->CNT - start) > IAP_TimeoutTicks) {
+                status = IAP_Status_Timeout;
+                break;
+            }
+        }
+        if(status != IAP_Status_OK) {
+            break;
+        }
+        DMA1->INTFCR = flag;
+
+        if(IAP_ProgramPage(address, &IAP_Buf[(page & 0x01) ? IAP_PageWords : 0]) != READY) {
+            IAP_SendByte(IAP_NAK);
+            status = IAP_Status_VerifyError;
+            break;
+        }
+        IAP_SendByte(IAP_ACK);
+        address += IAP_PageSize;
+    }
+
+    FLASH_Lock_Fast();
+    IAP_RX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    USART_DMACmd(USART1, USART_DMAReq_Rx, DISABLE);
+    if(status != IAP_Status_OK) {
+        return status;
+    }
+
+    /* End-to-end check over what actually landed in flash */
+    check = FRAME_CRC16_INIT;
+    for(address = IAP_Base; address < IAP_Base + ((uint32_t)pages * IAP_PageSize); address++) {
+        check = FRAME_CRC16Update(check, *(__IO uint8_t *)address);
+    }
+    if(check != crc) {
+        IAP_SendByte(IAP_NAK);
+        return IAP_Status_CRCError;
+    }
+    IAP_SendByte(IAP_ACK);
+    return IAP_Status_OK;
+}
+
+/**
+ * @brief   Selects the user area as start mode and resets the chip.
+ *        Called by the bootloader once a valid image is in place.
+ * @return  none
+ */
+void IAP_JumpToUser(void) {
+    while((USART1->STATR & USART_STATR_TC) == 0)
+        ;
+    SystemReset_StartMode(Start_Mode_USER);
+    NVIC_SystemReset();
+}
+
+/**
+ * @brief   Selects the boot area as start mode and resets the chip.
+ *        Called by the application to request a field update.
+ * @return  none
+ */
+void IAP_JumpToBoot(void) {
+    SystemReset_StartMode(Start_Mode_BOOT);
+    NVIC_SystemReset();
+}
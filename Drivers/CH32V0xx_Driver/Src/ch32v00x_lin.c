@@ -0,0 +1,420 @@
+#include "ch32v00x_lin.h"
+#include "ch32v00x_gpio.h"
+#include "ch32v00x_pwr.h"
+#include "ch32v00x_tim.h"
+#include "ch32v00x_usart.h"
+#include "system_ch32v00x.h"
+
+/* Slave states */
+#define LIN_STATE_IDLE           ((uint8_t)0x00)
+#define LIN_STATE_SYNC           ((uint8_t)0x01)
+#define LIN_STATE_PID            ((uint8_t)0x02)
+#define LIN_STATE_RX             ((uint8_t)0x03)
+#define LIN_STATE_TX             ((uint8_t)0x04)
+
+/* Falling edges in the 0x55 sync field, the first and last are 8 bit times apart */
+#define LIN_SYNC_EDGES           ((uint8_t)5)
+
+/* Master request frame used for the go-to-sleep command */
+static const LIN_FrameTypeDef LIN_SleepFrame = {
+    LIN_Id_MasterRequest, LIN_Direction_Subscribe, 8, LIN_Checksum_Classic, 0,
+};
+
+static const LIN_FrameTypeDef *LIN_Table = 0;
+static uint8_t   LIN_TableSize = 0;
+static void (*LIN_OnSleep)(void) = 0;
+
+static const LIN_FrameTypeDef *LIN_Frame = 0;
+static volatile uint8_t LIN_State = LIN_STATE_IDLE;
+static volatile uint8_t LIN_Status = LIN_Status_Active;
+static uint8_t   LIN_Data[8];
+static uint8_t   LIN_Index = 0;
+static uint8_t   LIN_Sum = 0;
+static uint8_t   LIN_Pid = 0;
+static uint8_t   LIN_AutoBaudEnabled = 0;
+static uint8_t   LIN_SyncEdges = 0;
+static uint16_t  LIN_SyncStart = 0;
+static uint16_t  LIN_NominalBRR = 0;
+static uint32_t  LIN_ExtiLine = 0;
+static volatile uint16_t LIN_IdleTicks = 0;
+static uint16_t  LIN_Errors = 0;
+
+/**
+ * @brief   Adds a byte to a LIN checksum (8-bit sum with end-around carry).
+ * @param   Sum - running sum.
+ *          Data - byte to add.
+ * @return  updated sum.
+ */
+static uint8_t LIN_SumAdd(uint8_t Sum, uint8_t Data) {
+    uint16_t tmp = (uint16_t)Sum + Data;
+
+    if(tmp > 0xFF) {
+        tmp -= 0xFF;
+    }
+    return (uint8_t)tmp;
+}
+
+static void LIN_Abort(void) {
+    LIN_Errors++;
+    LIN_State = LIN_STATE_IDLE;
+}
+
+/**
+ * @brief   Computes the protected identifier (ID plus parity bits P0, P1).
+ * @param   Id - frame identifier, 0 to 63.
+ * @return  protected identifier.
+ */
+uint8_t LIN_ProtectedId(uint8_t Id) {
+    uint8_t p0, p1;
+
+    Id &= 0x3F;
+    p0 = (Id ^ (Id >> 1) ^ (Id >> 2) ^ (Id >> 4)) & 0x01;
+    p1 = ~((Id >> 1) ^ (Id >> 3) ^ (Id >> 4) ^ (Id >> 5)) & 0x01;
+    return (uint8_t)(Id | (p0 << 6) | (p1 << 7));
+}
+
+/**
+ * @brief   Looks up the frame table entry for a received identifier.
+ * @param   Id - frame identifier, 0 to 63.
+ * @return  matching entry, 0 if this node does not take part in the frame.
+ */
+static const LIN_FrameTypeDef *LIN_FindFrame(uint8_t Id) {
+    uint8_t i;
+
+    for(i = 0; i < LIN_TableSize; i++) {
+        if(LIN_Table[i].LIN_Id == Id) {
+            return &LIN_Table[i];
+        }
+    }
+    if(Id == LIN_Id_MasterRequest) {
+        return &LIN_SleepFrame;
+    }
+    return 0;
+}
+
+/**
+ * @brief   Starts the response phase once a valid protected identifier
+ *        has been received.
+ * @return  none
+ */
+static void LIN_StartResponse(void) {
+    uint8_t i;
+
+    LIN_Index = 0;
+    LIN_Sum = 0;
+    if((LIN_Frame->LIN_Checksum == LIN_Checksum_Enhanced) && (LIN_Frame->LIN_Id != LIN_Id_MasterRequest) &&
+       (LIN_Frame->LIN_Id != LIN_Id_SlaveResponse)) {
+        LIN_Sum = LIN_Pid;
+    }
+
+    if(LIN_Frame->LIN_Direction == LIN_Direction_Publish) {
+        if(LIN_Frame->LIN_Handler != 0) {
+            LIN_Frame->LIN_Handler(LIN_Frame->LIN_Id, LIN_Data, LIN_Frame->LIN_Length);
+        }
+        for(i = 0; i < LIN_Frame->LIN_Length; i++) {
+            LIN_Sum = LIN_SumAdd(LIN_Sum, LIN_Data[i]);
+        }
+        LIN_Sum = (uint8_t)~LIN_Sum;
+        LIN_State = LIN_STATE_TX;
+        USART1->DATAR = LIN_Data[0];
+    }
+    else {
+        LIN_State = LIN_STATE_RX;
+    }
+}
+
+/**
+ * @brief   Advances the slave state machine with one received byte.
+ * @param   Data - byte read from the USART.
+ * @return  none
+ */
+static void LIN_RxByte(uint8_t Data) {
+    uint8_t expected;
+
+    switch(LIN_State) {
+        case LIN_STATE_SYNC:
+            if(LIN_AutoBaudEnabled) {
+                /* The sync byte itself was sampled at the old rate, only the measurement counts */
+                if(LIN_SyncEdges != 0xFF) {
+                    LIN_Abort();
+                    return;
+                }
+            }
+            else if(Data != LIN_SyncByte) {
+                LIN_Abort();
+                return;
+            }
+            LIN_State = LIN_STATE_PID;
+            break;
+
+        case LIN_STATE_PID:
+            if(LIN_ProtectedId(Data) != Data) {
+                LIN_Abort();
+                return;
+            }
+            LIN_Pid = Data;
+            LIN_Frame = LIN_FindFrame(Data & 0x3F);
+            if(LIN_Frame == 0) {
+                LIN_State = LIN_STATE_IDLE;
+                return;
+            }
+            LIN_StartResponse();
+            break;
+
+        case LIN_STATE_RX:
+            if(LIN_Index < LIN_Frame->LIN_Length) {
+                LIN_Data[LIN_Index++] = Data;
+                LIN_Sum = LIN_SumAdd(LIN_Sum, Data);
+                return;
+            }
+            LIN_State = LIN_STATE_IDLE;
+            if(LIN_SumAdd(LIN_Sum, Data) != 0xFF) {
+                LIN_Errors++;
+                return;
+            }
+            if((LIN_Frame->LIN_Id == LIN_Id_MasterRequest) && (LIN_Data[0] == 0x00)) {
+                LIN_GotoSleep();
+            }
+            if(LIN_Frame->LIN_Handler != 0) {
+                LIN_Frame->LIN_Handler(LIN_Frame->LIN_Id, LIN_Data, LIN_Frame->LIN_Length);
+            }
+            break;
+
+        case LIN_STATE_TX:
+            /* Single-wire bus: every byte sent comes back and is checked for bit errors */
+            expected = (LIN_Index < LIN_Frame->LIN_Length) ? LIN_Data[LIN_Index] : LIN_Sum;
+            if(Data != expected) {
+                LIN_Abort();
+                return;
+            }
+            LIN_Index++;
+            if(LIN_Index < LIN_Frame->LIN_Length) {
+                USART1->DATAR = LIN_Data[LIN_Index];
+            }
+            else if(LIN_Index == LIN_Frame->LIN_Length) {
+                USART1->DATAR = LIN_Sum;
+            }
+            else {
+                LIN_State = LIN_STATE_IDLE;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief   Initializes USART1 as a LIN 2.x slave according to the
+ *        specified parameters in the LIN_InitStruct.
+ *          Peripheral clocks, the RX/TX pins and the USART1 (and, with
+ *        auto-baud, EXTI7_0) NVIC channels must be configured by the
+ *        application, which also has to call LIN_USART_IRQHandler() from
+ *        USART1_IRQHandler() and LIN_EXTI_IRQHandler() from
+ *        EXTI7_0_IRQHandler(). Auto-baud uses TIM2 as a free-running
+ *        counter.
+ * @param   LIN_InitStruct - pointer to a LIN_InitTypeDef structure.
+ * @return  none
+ */
+void LIN_Init(LIN_InitTypeDef *LIN_InitStruct) {
+    USART_InitTypeDef       USART_InitStructure;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+
+    LIN_Table = LIN_InitStruct->LIN_FrameTable;
+    LIN_TableSize = LIN_InitStruct->LIN_FrameTableSize;
+    LIN_OnSleep = LIN_InitStruct->LIN_SleepCallback;
+    LIN_AutoBaudEnabled = (LIN_InitStruct->LIN_AutoBaud != DISABLE);
+    LIN_ExtiLine = (uint32_t)1 << LIN_InitStruct->LIN_RxPinSource;
+    LIN_State = LIN_STATE_IDLE;
+    LIN_Status = LIN_Status_Active;
+    LIN_IdleTicks = 0;
+    LIN_Errors = 0;
+
+    USART_StructInit(&USART_InitStructure);
+    USART_InitStructure.USART_BaudRate = LIN_InitStruct->LIN_BaudRate;
+    USART_Init(USART1, &USART_InitStructure);
+    LIN_NominalBRR = USART1->BRR;
+    USART_LINBreakDetectLengthConfig(USART1, USART_LINBreakDetectLength_11b);
+    USART_LINCmd(USART1, ENABLE);
+
+    /* The RX pin drives an EXTI line: interrupts time the sync field, events wake from standby */
+    GPIO_EXTILineConfig(LIN_InitStruct->LIN_RxPortSource, LIN_InitStruct->LIN_RxPinSource);
+    EXTI->INTENR &= ~LIN_ExtiLine;
+    EXTI->EVENR &= ~LIN_ExtiLine;
+    EXTI->RTENR &= ~LIN_ExtiLine;
+    EXTI->FTENR |= LIN_ExtiLine;
+
+    if(LIN_AutoBaudEnabled) {
+        /* One tick is 8 PCLK cycles, so 8 bit times measure exactly PCLK / baud = BRR */
+        TIM_TimeBaseStructInit(&TIM_TimeBaseInitStructure);
+        TIM_TimeBaseInitStructure.TIM_Prescaler = 7;
+        TIM_TimeBaseInitStructure.TIM_Period = 0xFFFF;
+        TIM_TimeBaseInit(TIM2, &TIM_TimeBaseInitStructure);
+        TIM_Cmd(TIM2, ENABLE);
+    }
+
+    USART_ITConfig(USART1, USART_IT_LBD, ENABLE);
+    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    USART_Cmd(USART1, ENABLE);
+}
+
+/**
+ * @brief   Fills each LIN_InitStruct member with its default value.
+ * @param   LIN_InitStruct - pointer to a LIN_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void LIN_StructInit(LIN_InitTypeDef *LIN_InitStruct) {
+    LIN_InitStruct->LIN_BaudRate = 19200;
+    LIN_InitStruct->LIN_AutoBaud = DISABLE;
+    LIN_InitStruct->LIN_RxPortSource = GPIO_PortSourceGPIOD;
+    LIN_InitStruct->LIN_RxPinSource = GPIO_PinSource6;
+    LIN_InitStruct->LIN_FrameTable = 0;
+    LIN_InitStruct->LIN_FrameTableSize = 0;
+    LIN_InitStruct->LIN_SleepCallback = 0;
+}
+
+/**
+ * @brief   Returns the bus status.
+ * @return  LIN_Status_Active or LIN_Status_Sleep.
+ */
+uint8_t LIN_GetStatus(void) {
+    return LIN_Status;
+}
+
+/**
+ * @brief   Returns the number of aborted frames (sync, parity, checksum
+ *        or readback errors) since LIN_Init().
+ * @return  error count.
+ */
+uint16_t LIN_GetErrorCount(void) {
+    return LIN_Errors;
+}
+
+/**
+ * @brief   Puts the node into bus sleep. Called internally on the
+ *        go-to-sleep command and after LIN_BusIdleTimeout ticks of silence.
+ * @return  none
+ */
+void LIN_GotoSleep(void) {
+    LIN_State = LIN_STATE_IDLE;
+    LIN_Status = LIN_Status_Sleep;
+    if(LIN_OnSleep != 0) {
+        LIN_OnSleep();
+    }
+}
+
+/**
+ * @brief   Wakes the cluster from sleep by sending a dominant pulse
+ *        (a 13-bit break, 650 us at 20 kbit/s).
+ * @return  none
+ */
+void LIN_SendWakeup(void) {
+    LIN_Status = LIN_Status_Active;
+    LIN_IdleTicks = 0;
+    USART_SendBreak(USART1);
+}
+
+/**
+ * @brief   Low-power idle hook for the main loop.
+ *          While the bus is active the core waits for the next interrupt
+ *        (sleep mode). Once the bus sleeps the chip enters standby and the
+ *        next falling edge on RX (a wake-up pulse or break) wakes it; the
+ *        system clock is then restored through SystemInit().
+ * @return  none
+ */
+void LIN_Idle(void) {
+    if(LIN_Status == LIN_Status_Sleep) {
+        EXTI->INTFR = LIN_ExtiLine;
+        EXTI->EVENR |= LIN_ExtiLine;
+        PWR_EnterSTANDBYMode(PWR_STANDBYEntry_WFE);
+        EXTI->EVENR &= ~LIN_ExtiLine;
+        SystemInit();
+        LIN_State = LIN_STATE_IDLE;
+        LIN_IdleTicks = 0;
+        LIN_Status = LIN_Status_Active;
+    }
+    else {
+        __WFI();
+    }
+}
+
+/**
+ * @brief   Bus inactivity timebase, to be called every millisecond.
+ *          After LIN_BusIdleTimeout ticks without bus traffic the node
+ *        goes to sleep as required by LIN 2.x.
+ * @return  none
+ */
+void LIN_Tick(void) {
+    if((LIN_Status == LIN_Status_Active) && (++LIN_IdleTicks >= LIN_BusIdleTimeout)) {
+        LIN_GotoSleep();
+    }
+}
+
+/**
+ * @brief   Services the USART1 interrupt for the LIN slave.
+ *          A break restarts the frame state machine from any state.
+ * @return  none
+ */
+void LIN_USART_IRQHandler(void) {
+    uint16_t statr = USART1->STATR;
+    uint8_t  data;
+
+    if(statr & USART_STATR_LBD) {
+        USART1->STATR = (uint16_t)~USART_STATR_LBD;
+        LIN_IdleTicks = 0;
+        LIN_Status = LIN_Status_Active;
+        LIN_State = LIN_STATE_SYNC;
+        LIN_SyncEdges = 0;
+        if(LIN_AutoBaudEnabled) {
+            EXTI->INTFR = LIN_ExtiLine;
+            EXTI->INTENR |= LIN_ExtiLine;
+        }
+    }
+
+    if(statr & (USART_STATR_RXNE | USART_STATR_ORE)) {
+        data = (uint8_t)USART1->DATAR;
+        LIN_IdleTicks = 0;
+        if(statr & (USART_STATR_FE | USART_STATR_ORE)) {
+            /* The break itself arrives as a framing error while waiting for sync */
+            if((LIN_State != LIN_STATE_SYNC) && (LIN_State != LIN_STATE_IDLE)) {
+                LIN_Abort();
+            }
+        }
+        else {
+            LIN_RxByte(data);
+        }
+    }
+}
+
+/**
+ * @brief   Services the EXTI interrupt of the RX pin during the sync
+ *        field and retunes USART1 to the measured bit rate.
+ * @return  none
+ */
+void LIN_EXTI_IRQHandler(void) {
+    uint16_t now = TIM2->CNT;
+    uint16_t span;
+    uint16_t tolerance;
+
+    EXTI->INTFR = LIN_ExtiLine;
+    if((LIN_State != LIN_STATE_SYNC) || (LIN_SyncEdges >= LIN_SYNC_EDGES)) {
+        EXTI->INTENR &= ~LIN_ExtiLine;
+        return;
+    }
+
+    if(LIN_SyncEdges == 0) {
+        LIN_SyncStart = now;
+    }
+    if(++LIN_SyncEdges < LIN_SYNC_EDGES) {
+        return;
+    }
+
+    EXTI->INTENR &= ~LIN_ExtiLine;
+    span = now - LIN_SyncStart;
+    tolerance = (LIN_NominalBRR >> 3) + (LIN_NominalBRR >> 5);
+    if((span > LIN_NominalBRR - tolerance) && (span < LIN_NominalBRR + tolerance)) {
+        USART1->BRR = span;
+        LIN_SyncEdges = 0xFF;
+    }
+}
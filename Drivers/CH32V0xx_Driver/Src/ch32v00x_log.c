@@ -0,0 +1,92 @@
+#include "ch32v00x_log.h"
+
+#define LOG_RingMask             (LOG_RingWords - 1)
+
+static uint32_t          LOG_Ring[LOG_RingWords];
+static volatile uint16_t LOG_Head = 0;
+static volatile uint16_t LOG_Tail = 0;
+static uint8_t           LOG_Byte = 0;
+static uint8_t           LOG_Seq = 0;
+static uint16_t          LOG_Drops = 0;
+
+/**
+ * @brief   Appends one record to the log ring. Normally called through
+ *        the LOG() macro.
+ *          The record is dropped, and the sequence number still advanced
+ *        so the host can see the gap, when the ring is full.
+ * @param   Id - address of the format string in the .log_fmt section.
+ *          Count - number of argument words.
+ *          Args - argument words.
+ * @return  none
+ */
+void LOG_Write(uint32_t Id, uint8_t Count, const uint32_t *Args) {
+    uint32_t mstatus;
+    uint16_t head;
+    uint8_t  i;
+
+    if(Count > LOG_MaxArgs) {
+        Count = LOG_MaxArgs;
+    }
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+
+    head = LOG_Head;
+    if((uint16_t)(LOG_RingWords - (uint16_t)(head - LOG_Tail)) <= Count) {
+        LOG_Seq++;
+        LOG_Drops++;
+        __set_MSTATUS(mstatus);
+        return;
+    }
+
+    LOG_Ring[head & LOG_RingMask] = LOG_HeaderSync | ((uint32_t)(LOG_Seq++ & 0x0F) << 20) |
+                                    ((uint32_t)Count << 16) | (Id & 0xFFFF);
+    for(i = 0; i < Count; i++) {
+        LOG_Ring[(head + 1 + i) & LOG_RingMask] = Args[i];
+    }
+    LOG_Head = head + 1 + Count;
+
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Drains the log ring as a little-endian byte stream, for any
+ *        transport (USART, SDI, ...). Must not be called from interrupts.
+ * @param   Data - destination buffer.
+ *          Size - size of Data.
+ * @return  number of bytes copied.
+ */
+uint16_t LOG_Read(uint8_t *Data, uint16_t Size) {
+    uint16_t count = 0;
+
+    while((count < Size) && (LOG_Tail != LOG_Head)) {
+        Data[count++] = (uint8_t)(LOG_Ring[LOG_Tail & LOG_RingMask] >> (LOG_Byte << 3));
+        if(++LOG_Byte == 4) {
+            LOG_Byte = 0;
+            LOG_Tail++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief   Moves pending log bytes to USART1 while its transmit data
+ *        register is empty; never waits. To be called from the main loop.
+ *          USART1 must be initialized and enabled by the application.
+ * @return  none
+ */
+void LOG_Process(void) {
+    uint8_t data;
+
+    while((USART1->STATR & USART_STATR_TXE) && (LOG_Read(&data, 1) != 0)) {
+        USART1->DATAR = data;
+    }
+}
+
+/**
+ * @brief   Returns the number of records dropped because the ring was full.
+ * @return  drop count.
+ */
+uint16_t LOG_GetDropCount(void) {
+    return LOG_Drops;
+}
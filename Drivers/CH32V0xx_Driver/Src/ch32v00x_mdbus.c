@@ -0,0 +1,408 @@
+#include "ch32v00x_mdbus.h"
+#include "ch32v00x_frame.h"
+#include "ch32v00x_usart.h"
+
+/* Bus states */
+#define MDBUS_STATE_IDLE         ((uint8_t)0x00)
+#define MDBUS_STATE_RX_ADDR      ((uint8_t)0x01)
+#define MDBUS_STATE_RX_LEN       ((uint8_t)0x02)
+#define MDBUS_STATE_RX_DATA      ((uint8_t)0x03)
+#define MDBUS_STATE_RX_CRC_H     ((uint8_t)0x04)
+#define MDBUS_STATE_RX_CRC_L     ((uint8_t)0x05)
+#define MDBUS_STATE_TX           ((uint8_t)0x06)
+
+static uint8_t        MDBUS_IsMaster = 0;
+static uint8_t        MDBUS_OwnAddress = 0;
+static uint8_t       *MDBUS_Buf = 0;
+static uint8_t        MDBUS_BufSize = 0;
+static GPIO_TypeDef  *MDBUS_DEGpio = 0;
+static uint16_t       MDBUS_DEMask = 0;
+static uint8_t (*MDBUS_OnRequest)(uint8_t *Data, uint8_t Length) = 0;
+
+static const MDBUS_NodeTypeDef *MDBUS_NodeTable = 0;
+static uint8_t        MDBUS_Nodes = 0;
+static uint8_t        MDBUS_NextNode = 0;
+static uint16_t       MDBUS_NextPoll[MDBUS_MaxNodes];
+static const MDBUS_NodeTypeDef *MDBUS_Current = 0;
+static uint16_t       MDBUS_Timeout = 0;
+static volatile uint16_t MDBUS_Ticks = 0;
+static volatile uint16_t MDBUS_Deadline = 0;
+
+static volatile uint8_t MDBUS_State = MDBUS_STATE_IDLE;
+static uint8_t        MDBUS_Peer = 0;
+static uint8_t        MDBUS_Len = 0;
+static uint16_t       MDBUS_Index = 0;
+static uint16_t       MDBUS_Crc = FRAME_CRC16_INIT;
+static uint16_t       MDBUS_Errors = 0;
+
+/**
+ * @brief   Puts a slave receiver back to mute until the next address
+ *        mark carrying its address nibble.
+ * @return  none
+ */
+static void MDBUS_Mute(void) {
+    MDBUS_State = MDBUS_STATE_IDLE;
+    if(!MDBUS_IsMaster) {
+        USART_ReceiverWakeUpCmd(USART1, ENABLE);
+    }
+}
+
+/**
+ * @brief   Ends the current master transaction and reports it.
+ * @param   Status - a value of @ref MDBUS_status.
+ * @return  none
+ */
+static void MDBUS_MasterDone(uint8_t Status) {
+    const MDBUS_NodeTypeDef *node = MDBUS_Current;
+
+    MDBUS_State = MDBUS_STATE_IDLE;
+    MDBUS_Current = 0;
+    if((node != 0) && (node->MDBUS_Response != 0)) {
+        node->MDBUS_Response(node->MDBUS_Address, MDBUS_Buf, (Status == MDBUS_Status_OK) ? MDBUS_Len : 0, Status);
+    }
+}
+
+static void MDBUS_Fail(void) {
+    MDBUS_Errors++;
+    if(MDBUS_IsMaster) {
+        MDBUS_MasterDone(MDBUS_Status_Error);
+    }
+    else {
+        MDBUS_Mute();
+    }
+}
+
+/**
+ * @brief   Starts interrupt-driven transmission of the frame
+ *        [address][length][payload][CRC-16].
+ * @param   Address - first byte; the address mark is added by the master.
+ *          Length - payload length in MDBUS_Buf.
+ * @return  none
+ */
+static void MDBUS_StartTx(uint8_t Address, uint8_t Length) {
+    uint16_t crc = FRAME_CRC16_INIT;
+    uint8_t  i;
+
+    crc = FRAME_CRC16Update(crc, Address);
+    crc = FRAME_CRC16Update(crc, Length);
+    for(i = 0; i < Length; i++) {
+        crc = FRAME_CRC16Update(crc, MDBUS_Buf[i]);
+    }
+
+    MDBUS_Peer = Address;
+    MDBUS_Len = Length;
+    MDBUS_Crc = crc;
+    MDBUS_Index = 0;
+    MDBUS_State = MDBUS_STATE_TX;
+    if(MDBUS_DEGpio != 0) {
+        MDBUS_DEGpio->BSHR = MDBUS_DEMask;
+    }
+    USART1->CTLR1 |= USART_CTLR1_TXEIE;
+}
+
+/**
+ * @brief   Returns the next 9-bit word of the frame being transmitted.
+ *        The index runs past 255 with a full payload, so it is 16-bit.
+ * @param   Data - pointer to the word to send.
+ * @return  SET if Data holds a word, RESET when the frame is complete.
+ */
+static FlagStatus MDBUS_TxNext(uint16_t *Data) {
+    uint16_t index = MDBUS_Index++;
+
+    if(index == 0) {
+        *Data = MDBUS_IsMaster ? (MDBUS_AddressMark | MDBUS_Peer) : MDBUS_Peer;
+    }
+    else if(index == 1) {
+        *Data = MDBUS_Len;
+    }
+    else if(index < (uint16_t)(MDBUS_Len + 2)) {
+        *Data = MDBUS_Buf[index - 2];
+    }
+    else if(index == (uint16_t)(MDBUS_Len + 2)) {
+        *Data = MDBUS_Crc >> 8;
+    }
+    else if(index == (uint16_t)(MDBUS_Len + 3)) {
+        *Data = MDBUS_Crc & 0xFF;
+    }
+    else {
+        return RESET;
+    }
+    return SET;
+}
+
+/**
+ * @brief   Called once the last stop bit has left the line.
+ * @return  none
+ */
+static void MDBUS_TxComplete(void) {
+    if(MDBUS_DEGpio != 0) {
+        MDBUS_DEGpio->BCR = MDBUS_DEMask;
+    }
+    if(MDBUS_IsMaster) {
+        MDBUS_Deadline = MDBUS_Ticks + MDBUS_Timeout;
+        MDBUS_State = MDBUS_STATE_RX_ADDR;
+    }
+    else {
+        MDBUS_Mute();
+    }
+}
+
+/**
+ * @brief   Called when a frame with a valid CRC has been received.
+ * @return  none
+ */
+static void MDBUS_RxComplete(void) {
+    uint8_t length = 0;
+
+    if(MDBUS_IsMaster) {
+        MDBUS_MasterDone(MDBUS_Status_OK);
+        return;
+    }
+    if(MDBUS_OnRequest != 0) {
+        length = MDBUS_OnRequest(MDBUS_Buf, MDBUS_Len);
+        if(length > MDBUS_BufSize) {
+            length = MDBUS_BufSize;
+        }
+    }
+    MDBUS_StartTx(MDBUS_OwnAddress, length);
+}
+
+/**
+ * @brief   Advances the receive state machine with one 9-bit word.
+ * @param   Data - word read from the USART.
+ * @return  none
+ */
+static void MDBUS_RxWord(uint16_t Data) {
+    uint8_t byte = (uint8_t)Data;
+
+    if(Data & MDBUS_AddressMark) {
+        /* Only the hardware nibble matched; anything else goes straight back to mute */
+        if(!MDBUS_IsMaster && (MDBUS_State != MDBUS_STATE_TX)) {
+            if(byte == MDBUS_OwnAddress) {
+                MDBUS_Crc = FRAME_CRC16Update(FRAME_CRC16_INIT, byte);
+                MDBUS_State = MDBUS_STATE_RX_LEN;
+            }
+            else {
+                MDBUS_Mute();
+            }
+        }
+        return;
+    }
+
+    switch(MDBUS_State) {
+        case MDBUS_STATE_RX_ADDR:
+            if(byte != MDBUS_Peer) {
+                MDBUS_Fail();
+                return;
+            }
+            MDBUS_Crc = FRAME_CRC16Update(FRAME_CRC16_INIT, byte);
+            MDBUS_State = MDBUS_STATE_RX_LEN;
+            break;
+
+        case MDBUS_STATE_RX_LEN:
+            if(byte > MDBUS_BufSize) {
+                MDBUS_Fail();
+                return;
+            }
+            MDBUS_Crc = FRAME_CRC16Update(MDBUS_Crc, byte);
+            MDBUS_Len = byte;
+            MDBUS_Index = 0;
+            MDBUS_State = (byte != 0) ? MDBUS_STATE_RX_DATA : MDBUS_STATE_RX_CRC_H;
+            break;
+
+        case MDBUS_STATE_RX_DATA:
+            MDBUS_Crc = FRAME_CRC16Update(MDBUS_Crc, byte);
+            MDBUS_Buf[MDBUS_Index++] = byte;
+            if(MDBUS_Index == MDBUS_Len) {
+                MDBUS_State = MDBUS_STATE_RX_CRC_H;
+            }
+            break;
+
+        case MDBUS_STATE_RX_CRC_H:
+            MDBUS_Crc = FRAME_CRC16Update(MDBUS_Crc, byte);
+            MDBUS_State = MDBUS_STATE_RX_CRC_L;
+            break;
+
+        case MDBUS_STATE_RX_CRC_L:
+            MDBUS_Crc = FRAME_CRC16Update(MDBUS_Crc, byte);
+            if(MDBUS_Crc != 0) {
+                MDBUS_Fail();
+                return;
+            }
+            MDBUS_RxComplete();
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief   Initializes USART1 as a 9-bit multi-drop bus node according to
+ *        the specified parameters in the MDBUS_InitStruct.
+ *          A slave is kept in mute mode by the hardware and only takes an
+ *        interrupt for address marks carrying the low nibble of its
+ *        address, and for the frames that follow them.
+ *          Peripheral clocks, pins and the USART1 NVIC channel must be
+ *        configured by the application, which also has to call
+ *        MDBUS_IRQHandler() from USART1_IRQHandler().
+ * @param   MDBUS_InitStruct - pointer to a MDBUS_InitTypeDef structure.
+ * @return  none
+ */
+void MDBUS_Init(MDBUS_InitTypeDef *MDBUS_InitStruct) {
+    USART_InitTypeDef USART_InitStructure;
+    uint8_t           i;
+
+    MDBUS_IsMaster = (MDBUS_InitStruct->MDBUS_Role == MDBUS_Role_Master);
+    MDBUS_OwnAddress = MDBUS_InitStruct->MDBUS_Address;
+    MDBUS_Buf = MDBUS_InitStruct->MDBUS_Buffer;
+    MDBUS_BufSize = (MDBUS_InitStruct->MDBUS_BufferSize > 0xFF) ? 0xFF : (uint8_t)MDBUS_InitStruct->MDBUS_BufferSize;
+    MDBUS_DEGpio = MDBUS_InitStruct->MDBUS_DEPort;
+    MDBUS_DEMask = MDBUS_InitStruct->MDBUS_DEPin;
+    MDBUS_OnRequest = MDBUS_InitStruct->MDBUS_RequestCallback;
+    MDBUS_NodeTable = MDBUS_InitStruct->MDBUS_Nodes;
+    MDBUS_Nodes = (MDBUS_InitStruct->MDBUS_NodeCount > MDBUS_MaxNodes) ? MDBUS_MaxNodes : MDBUS_InitStruct->MDBUS_NodeCount;
+    MDBUS_Timeout = MDBUS_InitStruct->MDBUS_Timeout;
+    MDBUS_NextNode = 0;
+    MDBUS_Current = 0;
+    MDBUS_Errors = 0;
+    MDBUS_State = MDBUS_STATE_IDLE;
+    for(i = 0; i < MDBUS_Nodes; i++) {
+        MDBUS_NextPoll[i] = MDBUS_Ticks;
+    }
+
+    if(MDBUS_DEGpio != 0) {
+        MDBUS_DEGpio->BCR = MDBUS_DEMask;
+    }
+
+    USART_StructInit(&USART_InitStructure);
+    USART_InitStructure.USART_BaudRate = MDBUS_InitStruct->MDBUS_BaudRate;
+    USART_InitStructure.USART_WordLength = USART_WordLength_9b;
+    USART_Init(USART1, &USART_InitStructure);
+
+    if(!MDBUS_IsMaster) {
+        USART_SetAddress(USART1, MDBUS_OwnAddress & 0x0F);
+        USART_WakeUpConfig(USART1, USART_WakeUp_AddressMark);
+    }
+    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    USART_Cmd(USART1, ENABLE);
+    if(!MDBUS_IsMaster) {
+        USART_ReceiverWakeUpCmd(USART1, ENABLE);
+    }
+}
+
+/**
+ * @brief   Fills each MDBUS_InitStruct member with its default value.
+ * @param   MDBUS_InitStruct - pointer to a MDBUS_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void MDBUS_StructInit(MDBUS_InitTypeDef *MDBUS_InitStruct) {
+    MDBUS_InitStruct->MDBUS_Role = MDBUS_Role_Slave;
+    MDBUS_InitStruct->MDBUS_BaudRate = 115200;
+    MDBUS_InitStruct->MDBUS_Address = 1;
+    MDBUS_InitStruct->MDBUS_Buffer = 0;
+    MDBUS_InitStruct->MDBUS_BufferSize = 0;
+    MDBUS_InitStruct->MDBUS_DEPort = 0;
+    MDBUS_InitStruct->MDBUS_DEPin = 0;
+    MDBUS_InitStruct->MDBUS_RequestCallback = 0;
+    MDBUS_InitStruct->MDBUS_Nodes = 0;
+    MDBUS_InitStruct->MDBUS_NodeCount = 0;
+    MDBUS_InitStruct->MDBUS_Timeout = 10;
+}
+
+/**
+ * @brief   Master polling scheduler, to be called from the main loop.
+ *          When the bus is free the next due node (round robin) is asked
+ *        for its request and the transaction is started; it then runs
+ *        entirely from interrupts.
+ * @return  none
+ */
+void MDBUS_MasterProcess(void) {
+    const MDBUS_NodeTypeDef *node;
+    uint8_t                  i, index;
+
+    if(!MDBUS_IsMaster || (MDBUS_State != MDBUS_STATE_IDLE)) {
+        return;
+    }
+
+    for(i = 0; i < MDBUS_Nodes; i++) {
+        index = MDBUS_NextNode;
+        if(++MDBUS_NextNode >= MDBUS_Nodes) {
+            MDBUS_NextNode = 0;
+        }
+        if((int16_t)(MDBUS_Ticks - MDBUS_NextPoll[index]) >= 0) {
+            node = &MDBUS_NodeTable[index];
+            MDBUS_NextPoll[index] = MDBUS_Ticks + node->MDBUS_Period;
+            MDBUS_Current = node;
+            MDBUS_StartTx(node->MDBUS_Address, (node->MDBUS_Request != 0) ? node->MDBUS_Request(node->MDBUS_Address, MDBUS_Buf) : 0);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief   Scheduler and reply-timeout timebase, to be called periodically
+ *        (typically every millisecond). The timeout check runs with
+ *        interrupts disabled so it cannot race the USART1 interrupt
+ *        completing the same transaction.
+ * @return  none
+ */
+void MDBUS_Tick(void) {
+    uint32_t mstatus;
+
+    MDBUS_Ticks++;
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    if(MDBUS_IsMaster && (MDBUS_State >= MDBUS_STATE_RX_ADDR) && (MDBUS_State <= MDBUS_STATE_RX_CRC_L) &&
+       ((int16_t)(MDBUS_Ticks - MDBUS_Deadline) >= 0)) {
+        MDBUS_Errors++;
+        MDBUS_MasterDone(MDBUS_Status_Timeout);
+    }
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Returns the number of failed frames (CRC, length, address or
+ *        timeout) since MDBUS_Init().
+ * @return  error count.
+ */
+uint16_t MDBUS_GetErrorCount(void) {
+    return MDBUS_Errors;
+}
+
+/**
+ * @brief   Services the USART1 interrupt for the multi-drop bus.
+ * @return  none
+ */
+void MDBUS_IRQHandler(void) {
+    uint16_t statr = USART1->STATR;
+    uint16_t data;
+
+    if(statr & (USART_STATR_RXNE | USART_STATR_ORE)) {
+        data = USART1->DATAR & USART_DATAR_DR;
+        if(statr & (USART_STATR_ORE | USART_STATR_FE)) {
+            if(MDBUS_State != MDBUS_STATE_IDLE) {
+                MDBUS_Fail();
+            }
+        }
+        else {
+            MDBUS_RxWord(data);
+        }
+    }
+
+    if((statr & USART_STATR_TXE) && (USART1->CTLR1 & USART_CTLR1_TXEIE)) {
+        if(MDBUS_TxNext(&data) == SET) {
+            USART1->DATAR = data;
+        }
+        else {
+            USART1->CTLR1 &= (uint16_t)~USART_CTLR1_TXEIE;
+            USART1->STATR = (uint16_t)~USART_STATR_TC;
+            USART1->CTLR1 |= USART_CTLR1_TCIE;
+        }
+    }
+    else if((statr & USART_STATR_TC) && (USART1->CTLR1 & USART_CTLR1_TCIE)) {
+        USART1->CTLR1 &= (uint16_t)~USART_CTLR1_TCIE;
+        MDBUS_TxComplete();
+    }
+}
@@ -0,0 +1,496 @@
+#include "ch32v00x_modbus.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_rcc.h"
+#include "ch32v00x_tim.h"
+#include "ch32v00x_usart.h"
+
+/* USART1 TX DMA channel */
+#define MODBUS_TX_DMA_Channel    DMA1_Channel4
+
+/* Slave states */
+#define MODBUS_STATE_IDLE        ((uint8_t)0x00)
+#define MODBUS_STATE_RX          ((uint8_t)0x01)
+#define MODBUS_STATE_PROCESS     ((uint8_t)0x02)
+#define MODBUS_STATE_TX          ((uint8_t)0x03)
+
+/* Fixed gaps above 19200 baud, in microseconds */
+#define MODBUS_T15_FIXED         ((uint16_t)750)
+#define MODBUS_T35_FIXED         ((uint16_t)1750)
+
+/* Nibble table for the reflected polynomial 0xA001 */
+static const uint16_t MODBUS_CrcTable[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+};
+
+static const MODBUS_RegionTypeDef *MODBUS_MapTable = 0;
+static uint8_t        MODBUS_MapEntries = 0;
+static uint8_t       *MODBUS_Buf = 0;
+static uint16_t       MODBUS_BufSize = 0;
+static GPIO_TypeDef  *MODBUS_DEGpio = 0;
+static uint16_t       MODBUS_DEMask = 0;
+static void (*MODBUS_OnWrite)(const MODBUS_RegionTypeDef *Region, uint16_t Address, uint16_t Count) = 0;
+
+static volatile uint8_t MODBUS_State = MODBUS_STATE_IDLE;
+static uint8_t        MODBUS_Address = 0;
+static uint8_t        MODBUS_RxFault = 0;
+static uint16_t       MODBUS_RxLen = 0;
+static uint16_t       MODBUS_RxCrc = MODBUS_CRC16_INIT;
+static uint16_t       MODBUS_RxGap = 0;
+static uint16_t       MODBUS_Errors = 0;
+
+/**
+ * @brief   Updates a CRC-16/MODBUS with one byte using a 16-entry
+ *        nibble table (two lookups per byte, no multiply).
+ * @param   Crc - current CRC value, MODBUS_CRC16_INIT for a new frame.
+ *          Data - byte to add.
+ * @return  updated CRC value.
+ */
+uint16_t MODBUS_CRC16Update(uint16_t Crc, uint8_t Data) {
+    Crc ^= Data;
+    Crc = (Crc >> 4) ^ MODBUS_CrcTable[Crc & 0x0F];
+    Crc = (Crc >> 4) ^ MODBUS_CrcTable[Crc & 0x0F];
+    return Crc;
+}
+
+static uint16_t MODBUS_Get16(const uint8_t *Buf) {
+    return (uint16_t)((Buf[0] << 8) | Buf[1]);
+}
+
+static void MODBUS_Put16(uint8_t *Buf, uint16_t Value) {
+    Buf[0] = (uint8_t)(Value >> 8);
+    Buf[1] = (uint8_t)Value;
+}
+
+static uint8_t MODBUS_GetBit(const uint8_t *Bits, uint16_t Index) {
+    return (Bits[Index >> 3] >> (Index & 0x07)) & 0x01;
+}
+
+static void MODBUS_SetBit(uint8_t *Bits, uint16_t Index, uint8_t Value) {
+    if(Value) {
+        Bits[Index >> 3] |= (uint8_t)(1 << (Index & 0x07));
+    }
+    else {
+        Bits[Index >> 3] &= (uint8_t)~(1 << (Index & 0x07));
+    }
+}
+
+/**
+ * @brief   Looks up the region of the register map that holds Count
+ *        objects of the given type starting at Address.
+ * @param   Type - object type, a value of @ref MODBUS_object_type.
+ *          Address - protocol address of the first object.
+ *          Count - number of objects.
+ * @return  matching region, 0 if the range is not fully mapped.
+ */
+static const MODBUS_RegionTypeDef *MODBUS_FindRegion(uint8_t Type, uint16_t Address, uint16_t Count) {
+    const MODBUS_RegionTypeDef *region;
+    uint8_t i;
+
+    for(i = 0; i < MODBUS_MapEntries; i++) {
+        region = &MODBUS_MapTable[i];
+        if((region->MODBUS_Type == Type) && (Address >= region->MODBUS_Address) &&
+           ((uint32_t)Address + Count <= (uint32_t)region->MODBUS_Address + region->MODBUS_Count)) {
+            return region;
+        }
+    }
+    return 0;
+}
+
+static uint16_t MODBUS_Exception(uint8_t *Frame, uint8_t Code) {
+    Frame[1] |= 0x80;
+    Frame[2] = Code;
+    return 3;
+}
+
+/**
+ * @brief   Executes the request held in the ADU buffer and builds the
+ *        reply in place.
+ * @param   Frame - ADU buffer, CRC already checked.
+ *          Length - ADU length without CRC.
+ * @return  reply length without CRC.
+ */
+static uint16_t MODBUS_Process(uint8_t *Frame, uint16_t Length) {
+    const MODBUS_RegionTypeDef *region;
+    const MODBUS_RegionTypeDef *wregion;
+    uint16_t address, count, waddress, wcount, offset, i;
+    uint8_t  bytes;
+    uint8_t  type;
+
+    /* Every function rejects a frame shorter than 6 bytes by its own length check */
+    address = 0;
+    count = 0;
+    if(Length >= 6) {
+        address = MODBUS_Get16(&Frame[2]);
+        count = MODBUS_Get16(&Frame[4]);
+    }
+
+    switch(Frame[1]) {
+        case MODBUS_FC_ReadCoils:
+        case MODBUS_FC_ReadDiscreteInputs:
+            bytes = (uint8_t)((count + 7) >> 3);
+            if((Length != 6) || (count == 0) || (count > 2000) || ((uint16_t)(bytes + 5) > MODBUS_BufSize)) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            type = (Frame[1] == MODBUS_FC_ReadCoils) ? MODBUS_Type_Coil : MODBUS_Type_DiscreteInput;
+            region = MODBUS_FindRegion(type, address, count);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            offset = address - region->MODBUS_Address;
+            Frame[2] = bytes;
+            for(i = 0; i < bytes; i++) {
+                Frame[3 + i] = 0;
+            }
+            for(i = 0; i < count; i++) {
+                if(MODBUS_GetBit((const uint8_t *)region->MODBUS_Data, offset + i)) {
+                    Frame[3 + (i >> 3)] |= (uint8_t)(1 << (i & 0x07));
+                }
+            }
+            return 3 + bytes;
+
+        case MODBUS_FC_ReadHoldingRegisters:
+        case MODBUS_FC_ReadInputRegisters:
+            if((Length != 6) || (count == 0) || (count > 125) || ((count << 1) + 5 > MODBUS_BufSize)) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            type = (Frame[1] == MODBUS_FC_ReadHoldingRegisters) ? MODBUS_Type_HoldingRegister : MODBUS_Type_InputRegister;
+            region = MODBUS_FindRegion(type, address, count);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            offset = address - region->MODBUS_Address;
+            Frame[2] = (uint8_t)(count << 1);
+            for(i = 0; i < count; i++) {
+                MODBUS_Put16(&Frame[3 + (i << 1)], ((const uint16_t *)region->MODBUS_Data)[offset + i]);
+            }
+            return 3 + (count << 1);
+
+        case MODBUS_FC_WriteSingleCoil:
+            if((Length != 6) || ((count != 0xFF00) && (count != 0x0000))) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            region = MODBUS_FindRegion(MODBUS_Type_Coil, address, 1);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            MODBUS_SetBit((uint8_t *)region->MODBUS_Data, address - region->MODBUS_Address, count != 0);
+            if(MODBUS_OnWrite != 0) {
+                MODBUS_OnWrite(region, address, 1);
+            }
+            return 6;
+
+        case MODBUS_FC_WriteSingleRegister:
+            if(Length != 6) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            region = MODBUS_FindRegion(MODBUS_Type_HoldingRegister, address, 1);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            ((uint16_t *)region->MODBUS_Data)[address - region->MODBUS_Address] = count;
+            if(MODBUS_OnWrite != 0) {
+                MODBUS_OnWrite(region, address, 1);
+            }
+            return 6;
+
+        case MODBUS_FC_WriteMultipleCoils:
+            bytes = (uint8_t)((count + 7) >> 3);
+            if((Length < 7) || (count == 0) || (count > 1968) || (Frame[6] != bytes) || (Length != 7 + bytes)) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            region = MODBUS_FindRegion(MODBUS_Type_Coil, address, count);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            offset = address - region->MODBUS_Address;
+            for(i = 0; i < count; i++) {
+                MODBUS_SetBit((uint8_t *)region->MODBUS_Data, offset + i, MODBUS_GetBit(&Frame[7], i));
+            }
+            if(MODBUS_OnWrite != 0) {
+                MODBUS_OnWrite(region, address, count);
+            }
+            return 6;
+
+        case MODBUS_FC_WriteMultipleRegisters:
+            if((Length < 7) || (count == 0) || (count > 123) || (Frame[6] != (uint8_t)(count << 1)) ||
+               (Length != 7 + (count << 1))) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            region = MODBUS_FindRegion(MODBUS_Type_HoldingRegister, address, count);
+            if(region == 0) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            offset = address - region->MODBUS_Address;
+            for(i = 0; i < count; i++) {
+                ((uint16_t *)region->MODBUS_Data)[offset + i] = MODBUS_Get16(&Frame[7 + (i << 1)]);
+            }
+            if(MODBUS_OnWrite != 0) {
+                MODBUS_OnWrite(region, address, count);
+            }
+            return 6;
+
+        case MODBUS_FC_ReadWriteMultipleRegisters:
+            if(Length < 11) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            waddress = MODBUS_Get16(&Frame[6]);
+            wcount = MODBUS_Get16(&Frame[8]);
+            if((count == 0) || (count > 125) || (wcount == 0) || (wcount > 121) ||
+               (Frame[10] != (uint8_t)(wcount << 1)) || (Length != 11 + (wcount << 1)) ||
+               ((count << 1) + 5 > MODBUS_BufSize)) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataValue);
+            }
+            region = MODBUS_FindRegion(MODBUS_Type_HoldingRegister, address, count);
+            wregion = MODBUS_FindRegion(MODBUS_Type_HoldingRegister, waddress, wcount);
+            if((region == 0) || (wregion == 0)) {
+                return MODBUS_Exception(Frame, MODBUS_EX_IllegalDataAddress);
+            }
+            /* The write is performed before the read, as required by the specification */
+            offset = waddress - wregion->MODBUS_Address;
+            for(i = 0; i < wcount; i++) {
+                ((uint16_t *)wregion->MODBUS_Data)[offset + i] = MODBUS_Get16(&Frame[11 + (i << 1)]);
+            }
+            if(MODBUS_OnWrite != 0) {
+                MODBUS_OnWrite(wregion, waddress, wcount);
+            }
+            offset = address - region->MODBUS_Address;
+            Frame[2] = (uint8_t)(count << 1);
+            for(i = 0; i < count; i++) {
+                MODBUS_Put16(&Frame[3 + (i << 1)], ((const uint16_t *)region->MODBUS_Data)[offset + i]);
+            }
+            return 3 + (count << 1);
+
+        default:
+            return MODBUS_Exception(Frame, MODBUS_EX_IllegalFunction);
+    }
+}
+
+/**
+ * @brief   Appends the CRC to the reply and hands it to DMA1 channel 4.
+ * @param   Length - reply length without CRC.
+ * @return  none
+ */
+static void MODBUS_StartTx(uint16_t Length) {
+    uint16_t crc = MODBUS_CRC16_INIT;
+    uint16_t i;
+
+    for(i = 0; i < Length; i++) {
+        crc = MODBUS_CRC16Update(crc, MODBUS_Buf[i]);
+    }
+    MODBUS_Buf[Length++] = (uint8_t)crc;
+    MODBUS_Buf[Length++] = (uint8_t)(crc >> 8);
+
+    MODBUS_State = MODBUS_STATE_TX;
+    if(MODBUS_DEGpio != 0) {
+        MODBUS_DEGpio->BSHR = MODBUS_DEMask;
+    }
+
+    MODBUS_TX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    MODBUS_TX_DMA_Channel->CNTR = Length;
+    MODBUS_TX_DMA_Channel->MADDR = (uint32_t)MODBUS_Buf;
+    USART1->STATR = (uint16_t)~USART_STATR_TC;
+    USART1->CTLR1 |= USART_CTLR1_TCIE;
+    MODBUS_TX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+}
+
+/**
+ * @brief   Initializes the Modbus RTU slave on USART1, TIM2 and DMA1
+ *        channel 4 according to the specified parameters in the
+ *        MODBUS_InitStruct.
+ *          Peripheral clocks, GPIO pins and the USART1 and TIM2 NVIC
+ *        channels must be configured by the application, which also has
+ *        to call MODBUS_USART_IRQHandler() from USART1_IRQHandler() and
+ *        MODBUS_TIM_IRQHandler() from TIM2_IRQHandler().
+ * @param   MODBUS_InitStruct - pointer to a MODBUS_InitTypeDef structure.
+ * @return  none
+ */
+void MODBUS_Init(MODBUS_InitTypeDef *MODBUS_InitStruct) {
+    USART_InitTypeDef       USART_InitStructure;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
+    DMA_InitTypeDef         DMA_InitStructure;
+    RCC_ClocksTypeDef       RCC_ClocksStatus;
+    uint16_t                t35;
+
+    MODBUS_MapTable = MODBUS_InitStruct->MODBUS_Map;
+    MODBUS_MapEntries = MODBUS_InitStruct->MODBUS_MapSize;
+    MODBUS_Buf = MODBUS_InitStruct->MODBUS_Buffer;
+    MODBUS_BufSize = MODBUS_InitStruct->MODBUS_BufferSize;
+    MODBUS_Address = MODBUS_InitStruct->MODBUS_SlaveAddress;
+    MODBUS_DEGpio = MODBUS_InitStruct->MODBUS_DEPort;
+    MODBUS_DEMask = MODBUS_InitStruct->MODBUS_DEPin;
+    MODBUS_OnWrite = MODBUS_InitStruct->MODBUS_WriteCallback;
+    MODBUS_State = MODBUS_STATE_IDLE;
+    MODBUS_Errors = 0;
+
+    if(MODBUS_DEGpio != 0) {
+        MODBUS_DEGpio->BCR = MODBUS_DEMask;
+    }
+
+    /* One character is 11 bits; above 19200 baud the gaps are fixed */
+    if(MODBUS_InitStruct->MODBUS_BaudRate > 19200) {
+        MODBUS_RxGap = MODBUS_T15_FIXED;
+        t35 = MODBUS_T35_FIXED;
+    }
+    else {
+        MODBUS_RxGap = (uint16_t)(16500000 / MODBUS_InitStruct->MODBUS_BaudRate);
+        t35 = (uint16_t)(38500000 / MODBUS_InitStruct->MODBUS_BaudRate);
+    }
+
+    /* TIM2 restarts on each RXNE, so it also counts the next character */
+    MODBUS_RxGap += (uint16_t)(11000000 / MODBUS_InitStruct->MODBUS_BaudRate);
+
+    USART_StructInit(&USART_InitStructure);
+    USART_InitStructure.USART_BaudRate = MODBUS_InitStruct->MODBUS_BaudRate;
+    USART_InitStructure.USART_Parity = MODBUS_InitStruct->MODBUS_Parity;
+    if(MODBUS_InitStruct->MODBUS_Parity != USART_Parity_No) {
+        USART_InitStructure.USART_WordLength = USART_WordLength_9b;
+    }
+    USART_Init(USART1, &USART_InitStructure);
+
+    /* TIM2 counts microseconds in one-pulse mode; the update event marks T3.5 */
+    RCC_GetClocksFreq(&RCC_ClocksStatus);
+    TIM_TimeBaseStructInit(&TIM_TimeBaseInitStructure);
+    TIM_TimeBaseInitStructure.TIM_Prescaler = (uint16_t)(RCC_ClocksStatus.PCLK1_Frequency / 1000000 - 1);
+    TIM_TimeBaseInitStructure.TIM_Period = t35;
+    TIM_TimeBaseInitStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseInitStructure);
+    TIM_SelectOnePulseMode(TIM2, TIM_OPMode_Single);
+    TIM_UpdateRequestConfig(TIM2, TIM_UpdateSource_Regular);
+    TIM_ClearFlag(TIM2, TIM_FLAG_Update);
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+
+    DMA_DeInit(MODBUS_TX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)MODBUS_Buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(MODBUS_TX_DMA_Channel, &DMA_InitStructure);
+
+    USART_DMACmd(USART1, USART_DMAReq_Tx, ENABLE);
+    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    USART_Cmd(USART1, ENABLE);
+}
+
+/**
+ * @brief   Fills each MODBUS_InitStruct member with its default value.
+ * @param   MODBUS_InitStruct - pointer to a MODBUS_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void MODBUS_StructInit(MODBUS_InitTypeDef *MODBUS_InitStruct) {
+    MODBUS_InitStruct->MODBUS_BaudRate = 19200;
+    MODBUS_InitStruct->MODBUS_Parity = USART_Parity_Even;
+    MODBUS_InitStruct->MODBUS_SlaveAddress = 1;
+    MODBUS_InitStruct->MODBUS_Map = 0;
+    MODBUS_InitStruct->MODBUS_MapSize = 0;
+    MODBUS_InitStruct->MODBUS_Buffer = 0;
+    MODBUS_InitStruct->MODBUS_BufferSize = 0;
+    MODBUS_InitStruct->MODBUS_DEPort = 0;
+    MODBUS_InitStruct->MODBUS_DEPin = 0;
+    MODBUS_InitStruct->MODBUS_WriteCallback = 0;
+}
+
+/**
+ * @brief   Returns the number of frames dropped because of CRC, parity,
+ *        overrun, overlength or T1.5 gap errors since MODBUS_Init().
+ * @return  error count.
+ */
+uint16_t MODBUS_GetErrorCount(void) {
+    return MODBUS_Errors;
+}
+
+/**
+ * @brief   Services the USART1 interrupt for the Modbus slave.
+ *          Each received byte restarts TIM2, and the counter value read
+ *        just before the restart is one character time plus the gap
+ *        since the previous byte.
+ *        The CRC is accumulated as bytes arrive, so no pass over the
+ *        frame is needed at T3.5.
+ * @return  none
+ */
+void MODBUS_USART_IRQHandler(void) {
+    uint16_t statr = USART1->STATR;
+    uint8_t  data;
+
+    if(statr & (USART_STATR_RXNE | USART_STATR_ORE)) {
+        data = (uint8_t)USART1->DATAR;
+        if(MODBUS_State == MODBUS_STATE_IDLE) {
+            MODBUS_State = MODBUS_STATE_RX;
+            MODBUS_RxLen = 0;
+            MODBUS_RxCrc = MODBUS_CRC16_INIT;
+            MODBUS_RxFault = 0;
+        }
+        else if((MODBUS_State == MODBUS_STATE_RX) && (TIM2->CNT > MODBUS_RxGap)) {
+            MODBUS_RxFault = 1;
+        }
+    }
+
+    /* Bytes seen while a reply is pending or on the wire are our own echo */
+    if((statr & (USART_STATR_RXNE | USART_STATR_ORE)) && (MODBUS_State == MODBUS_STATE_RX)) {
+        TIM2->CNT = 0;
+        TIM2->CTLR1 |= TIM_CEN;
+
+        if(statr & (USART_STATR_ORE | USART_STATR_FE | USART_STATR_PE)) {
+            MODBUS_RxFault = 1;
+        }
+        if(MODBUS_RxLen < MODBUS_BufSize) {
+            MODBUS_Buf[MODBUS_RxLen++] = data;
+            MODBUS_RxCrc = MODBUS_CRC16Update(MODBUS_RxCrc, data);
+        }
+        else {
+            MODBUS_RxFault = 1;
+        }
+    }
+
+    if((statr & USART_STATR_TC) && (USART1->CTLR1 & USART_CTLR1_TCIE)) {
+        USART1->CTLR1 &= (uint16_t)~USART_CTLR1_TCIE;
+        if(MODBUS_DEGpio != 0) {
+            MODBUS_DEGpio->BCR = MODBUS_DEMask;
+        }
+        MODBUS_State = MODBUS_STATE_IDLE;
+    }
+}
+
+/**
+ * @brief   Services the TIM2 update interrupt raised after T3.5 of bus
+ *        silence: validates the frame, executes it and starts the reply.
+ * @return  none
+ */
+void MODBUS_TIM_IRQHandler(void) {
+    uint16_t length;
+    uint8_t  address;
+
+    TIM2->INTFR = (uint16_t)~TIM_UIF;
+    if(MODBUS_State != MODBUS_STATE_RX) {
+        return;
+    }
+    MODBUS_State = MODBUS_STATE_PROCESS;
+
+    if(MODBUS_RxFault || (MODBUS_RxLen < 4) || (MODBUS_RxCrc != 0)) {
+        MODBUS_Errors++;
+        MODBUS_State = MODBUS_STATE_IDLE;
+        return;
+    }
+
+    address = MODBUS_Buf[0];
+    if((address != MODBUS_Address) && (address != MODBUS_BroadcastAddress)) {
+        MODBUS_State = MODBUS_STATE_IDLE;
+        return;
+    }
+
+    length = MODBUS_Process(MODBUS_Buf, MODBUS_RxLen - 2);
+    if(address == MODBUS_BroadcastAddress) {
+        MODBUS_State = MODBUS_STATE_IDLE;
+    }
+    else {
+        MODBUS_StartTx(length);
+    }
+}
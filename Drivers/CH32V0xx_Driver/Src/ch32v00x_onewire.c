@@ -0,0 +1,377 @@
+#include "ch32v00x_onewire.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_usart.h"
+
+/* USART1 DMA channels */
+#define OW_TX_DMA_Channel        DMA1_Channel4
+#define OW_RX_DMA_Channel        DMA1_Channel5
+
+/* Slot timing: one UART character per slot at 115200 baud, reset pulse at 9600 baud */
+#define OW_SlotBaudRate          ((uint32_t)115200)
+
+/* Characters sent on the wire */
+#define OW_SlotOne               ((uint8_t)0xFF)
+#define OW_SlotZero              ((uint8_t)0x00)
+#define OW_ResetPulse            ((uint8_t)0xF0)
+
+/* Busy-wait bound for one character or one 8-slot DMA transfer */
+#define OW_Timeout               ((uint32_t)0x00010000)
+
+/* Nibble table for the reflected polynomial 0x8C */
+static const uint8_t OW_CrcTable[16] = {
+    0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8,
+    0x8C, 0x11, 0xAF, 0x32, 0xCA, 0x57, 0xE9, 0x74,
+};
+
+static uint8_t  OW_Slots[8];
+static uint16_t OW_SlotBRR = 0;
+static uint16_t OW_ResetBRR = 0;
+static uint16_t OW_Errors = 0;
+
+/* ROM search state */
+static uint8_t  OW_SearchRom[OW_RomSize];
+static uint8_t  OW_LastDiscrepancy = 0;
+static uint8_t  OW_LastDevice = 0;
+
+/**
+ * @brief   Sends one character and returns what was read back from the
+ *        wire. On timeout the character itself is returned, which reads
+ *        as an idle bus.
+ * @param   Data - character to send.
+ * @return  character read back.
+ */
+static uint8_t OW_Exchange(uint8_t Data) {
+    uint32_t timeout = OW_Timeout;
+
+    (void)USART1->STATR;
+    (void)USART1->DATAR;
+    USART1->DATAR = Data;
+    while((USART1->STATR & USART_STATR_RXNE) == 0) {
+        if(--timeout == 0) {
+            OW_Errors++;
+            return Data;
+        }
+    }
+    return (uint8_t)USART1->DATAR;
+}
+
+/**
+ * @brief   Runs Length slots from OW_Slots through DMA1 channels 4 and 5.
+ *          The read-back overwrites OW_Slots in place; the TX channel is
+ *        always ahead of the RX channel so no slot is lost.
+ * @param   Length - number of slots, 1 to 8.
+ * @return  READY if all slots were read back, NoREADY on timeout.
+ */
+static ErrorStatus OW_Transfer(uint8_t Length) {
+    uint32_t timeout = OW_Timeout;
+
+    (void)USART1->STATR;
+    (void)USART1->DATAR;
+
+    OW_RX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    OW_TX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    DMA1->INTFCR = DMA1_FLAG_GL4 | DMA1_FLAG_GL5;
+    OW_RX_DMA_Channel->CNTR = Length;
+    OW_TX_DMA_Channel->CNTR = Length;
+    OW_RX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+    OW_TX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+
+    while((DMA1->INTFR & DMA1_FLAG_TC5) == 0) {
+        if(--timeout == 0) {
+            break;
+        }
+    }
+
+    OW_TX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    OW_RX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    if(timeout == 0) {
+        OW_Errors++;
+        return NoREADY;
+    }
+    return READY;
+}
+
+/**
+ * @brief   Initializes USART1 as a single-wire 1-Wire bus master with
+ *        DMA1 channels 4 (TX) and 5 (RX).
+ *          Every slot is one UART character at 115200 baud, so a byte is
+ *        a single 8-character DMA transfer and interrupts stay enabled
+ *        for the whole exchange. The reset pulse is one character at
+ *        9600 baud.
+ *          Peripheral clocks must be enabled by the application, and the
+ *        USART1 TX pin configured as alternate function open-drain with
+ *        an external pull-up to the bus supply.
+ * @return  none
+ */
+void OW_Init(void) {
+    USART_InitTypeDef USART_InitStructure;
+    DMA_InitTypeDef   DMA_InitStructure;
+
+    USART_StructInit(&USART_InitStructure);
+    USART_InitStructure.USART_BaudRate = OW_SlotBaudRate;
+    USART_Init(USART1, &USART_InitStructure);
+    OW_SlotBRR = USART1->BRR;
+    /* 115200 / 9600 = 12 */
+    OW_ResetBRR = (OW_SlotBRR << 3) + (OW_SlotBRR << 2);
+    USART_HalfDuplexCmd(USART1, ENABLE);
+
+    DMA_DeInit(OW_TX_DMA_Channel);
+    DMA_DeInit(OW_RX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)OW_Slots;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(OW_TX_DMA_Channel, &DMA_InitStructure);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_Init(OW_RX_DMA_Channel, &DMA_InitStructure);
+
+    USART_DMACmd(USART1, USART_DMAReq_Tx | USART_DMAReq_Rx, ENABLE);
+    USART_Cmd(USART1, ENABLE);
+
+    OW_Errors = 0;
+    OW_SearchReset();
+}
+
+/**
+ * @brief   Issues a reset pulse and samples the presence pulse.
+ * @return  SET if at least one device answered, RESET otherwise.
+ */
+FlagStatus OW_Reset(void) {
+    uint8_t data;
+
+    USART1->BRR = OW_ResetBRR;
+    data = OW_Exchange(OW_ResetPulse);
+    USART1->BRR = OW_SlotBRR;
+
+    return (data != OW_ResetPulse) ? SET : RESET;
+}
+
+/**
+ * @brief   Generates a single write or read slot.
+ * @param   Bit - 0 for a write-0 slot, 1 for a write-1 or read slot.
+ * @return  bit read back from the bus.
+ */
+uint8_t OW_TouchBit(uint8_t Bit) {
+    return (OW_Exchange(Bit ? OW_SlotOne : OW_SlotZero) == OW_SlotOne) ? 1 : 0;
+}
+
+/**
+ * @brief   Generates eight slots, LSB first, in one DMA transfer.
+ * @param   Data - byte to write, 0xFF to read.
+ * @return  byte read back from the bus.
+ */
+uint8_t OW_TouchByte(uint8_t Data) {
+    uint8_t i, result = 0;
+
+    for(i = 0; i < 8; i++) {
+        OW_Slots[i] = (Data & 0x01) ? OW_SlotOne : OW_SlotZero;
+        Data >>= 1;
+    }
+    if(OW_Transfer(8) != READY) {
+        return 0xFF;
+    }
+    for(i = 8; i > 0; i--) {
+        result >>= 1;
+        if(OW_Slots[i - 1] == OW_SlotOne) {
+            result |= 0x80;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief   Writes one byte to the bus.
+ * @param   Data - byte to write.
+ * @return  none
+ */
+void OW_WriteByte(uint8_t Data) {
+    OW_TouchByte(Data);
+}
+
+/**
+ * @brief   Reads one byte from the bus.
+ * @return  byte read.
+ */
+uint8_t OW_ReadByte(void) {
+    return OW_TouchByte(0xFF);
+}
+
+/**
+ * @brief   Writes a block of bytes to the bus.
+ * @param   Data - bytes to write.
+ *          Length - number of bytes.
+ * @return  none
+ */
+void OW_Write(const uint8_t *Data, uint16_t Length) {
+    while(Length--) {
+        OW_TouchByte(*Data++);
+    }
+}
+
+/**
+ * @brief   Reads a block of bytes from the bus.
+ * @param   Data - destination buffer.
+ *          Length - number of bytes.
+ * @return  none
+ */
+void OW_Read(uint8_t *Data, uint16_t Length) {
+    while(Length--) {
+        *Data++ = OW_TouchByte(0xFF);
+    }
+}
+
+/**
+ * @brief   Resets the bus and addresses one device (Match ROM) or all
+ *        devices (Skip ROM).
+ * @param   Rom - 8-byte ROM code of the device, 0 to address all devices.
+ * @return  READY if a presence pulse was seen, NoREADY otherwise.
+ */
+ErrorStatus OW_Select(const uint8_t *Rom) {
+    if(OW_Reset() != SET) {
+        return NoREADY;
+    }
+    if(Rom == 0) {
+        OW_TouchByte(OW_CMD_SkipRom);
+    }
+    else {
+        OW_TouchByte(OW_CMD_MatchRom);
+        OW_Write(Rom, OW_RomSize);
+    }
+    return READY;
+}
+
+/**
+ * @brief   Restarts the ROM search from the first device.
+ * @return  none
+ */
+void OW_SearchReset(void) {
+    uint8_t i;
+
+    for(i = 0; i < OW_RomSize; i++) {
+        OW_SearchRom[i] = 0;
+    }
+    OW_LastDiscrepancy = 0;
+    OW_LastDevice = 0;
+}
+
+/**
+ * @brief   Finds the next device on the bus with the binary-tree ROM
+ *        search. Call OW_SearchReset() first, then call repeatedly until
+ *        it returns NoREADY.
+ * @param   Rom - receives the 8-byte ROM code of the device found.
+ *          Command - OW_CMD_SearchRom for all devices, OW_CMD_AlarmSearch
+ *        for devices with an alarm condition.
+ * @return  READY if a device with a valid ROM CRC was found, NoREADY when
+ *        the search is complete or failed.
+ */
+ErrorStatus OW_Search(uint8_t *Rom, uint8_t Command) {
+    uint8_t bit, id, cmp, dir, lastZero = 0;
+    uint8_t index = 0, mask = 0x01;
+
+    if(OW_LastDevice || (OW_Reset() != SET)) {
+        OW_SearchReset();
+        return NoREADY;
+    }
+    OW_TouchByte(Command);
+
+    for(bit = 1; bit <= 64; bit++) {
+        id = OW_TouchBit(1);
+        cmp = OW_TouchBit(1);
+        if(id && cmp) {
+            /* No device answered this bit */
+            OW_SearchReset();
+            return NoREADY;
+        }
+        if(id != cmp) {
+            dir = id;
+        }
+        else {
+            /* Discrepancy: devices with both values are present */
+            if(bit < OW_LastDiscrepancy) {
+                dir = (OW_SearchRom[index] & mask) ? 1 : 0;
+            }
+            else {
+                dir = (bit == OW_LastDiscrepancy) ? 1 : 0;
+            }
+            if(dir == 0) {
+                lastZero = bit;
+            }
+        }
+
+        if(dir) {
+            OW_SearchRom[index] |= mask;
+        }
+        else {
+            OW_SearchRom[index] &= (uint8_t)~mask;
+        }
+        OW_TouchBit(dir);
+
+        mask <<= 1;
+        if(mask == 0) {
+            mask = 0x01;
+            index++;
+        }
+    }
+
+    if(OW_CRC8(OW_SearchRom, OW_RomSize) != 0) {
+        OW_Errors++;
+        OW_SearchReset();
+        return NoREADY;
+    }
+
+    OW_LastDiscrepancy = lastZero;
+    if(lastZero == 0) {
+        OW_LastDevice = 1;
+    }
+    for(index = 0; index < OW_RomSize; index++) {
+        Rom[index] = OW_SearchRom[index];
+    }
+    return READY;
+}
+
+/**
+ * @brief   Updates a CRC-8/MAXIM (Dallas 1-Wire) with one byte using a
+ *        16-entry nibble table.
+ * @param   Crc - current CRC value, OW_CRC8_INIT for a new block.
+ *          Data - byte to add.
+ * @return  updated CRC value.
+ */
+uint8_t OW_CRC8Update(uint8_t Crc, uint8_t Data) {
+    Crc ^= Data;
+    Crc = (Crc >> 4) ^ OW_CrcTable[Crc & 0x0F];
+    Crc = (Crc >> 4) ^ OW_CrcTable[Crc & 0x0F];
+    return Crc;
+}
+
+/**
+ * @brief   Computes the CRC-8/MAXIM of a block. A block that ends with its
+ *        own CRC (ROM code, scratchpad) yields 0.
+ * @param   Data - block to check.
+ *          Length - number of bytes.
+ * @return  CRC value.
+ */
+uint8_t OW_CRC8(const uint8_t *Data, uint16_t Length) {
+    uint8_t crc = OW_CRC8_INIT;
+
+    while(Length--) {
+        crc = OW_CRC8Update(crc, *Data++);
+    }
+    return crc;
+}
+
+/**
+ * @brief   Returns the number of bus timeouts and ROM CRC failures since
+ *        OW_Init().
+ * @return  error count.
+ */
+uint16_t OW_GetErrorCount(void) {
+    return OW_Errors;
+}
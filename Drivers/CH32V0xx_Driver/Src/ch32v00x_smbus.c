@@ -0,0 +1,392 @@
+#include "ch32v00x_smbus.h"
+#include "ch32v00x_i2c.h"
+#include "ch32v00x_i2cm.h"
+
+static I2CM_TransferTypeDef SMBUS_Transfer;
+static uint8_t              SMBUS_TxBuffer[2 + SMBUS_BlockMax];
+static uint8_t              SMBUS_RxBuffer[1 + SMBUS_BlockMax + 1];
+static uint8_t              SMBUS_Flags = I2CM_Flag_None;
+
+/**
+ * @brief   Runs one host transaction: the bytes in SMBUS_TxBuffer, then
+ *        with a repeated START a read into SMBUS_RxBuffer. With PEC
+ *        enabled the PEC byte is appended to the read.
+ * @param   Address - 7-bit slave address.
+ *          TxLength - bytes to write from SMBUS_TxBuffer.
+ *          RxLength - bytes to read, the buffer size for a block read.
+ *          Flags - I2CM_Flag_PEC forces PEC, I2CM_Flag_Block reads a block.
+ * @return  a value of @ref I2CM_status.
+ */
+static uint8_t SMBUS_Run(uint8_t Address, uint16_t TxLength, uint16_t RxLength, uint8_t Flags) {
+    Flags |= SMBUS_Flags;
+    if((Flags & I2CM_Flag_PEC) && (RxLength != 0) && !(Flags & I2CM_Flag_Block)) {
+        RxLength++;
+    }
+    SMBUS_Transfer.I2CM_Address = Address;
+    SMBUS_Transfer.I2CM_TxData = SMBUS_TxBuffer;
+    SMBUS_Transfer.I2CM_TxLength = TxLength;
+    SMBUS_Transfer.I2CM_RxData = SMBUS_RxBuffer;
+    SMBUS_Transfer.I2CM_RxLength = RxLength;
+    SMBUS_Transfer.I2CM_Flags = Flags;
+    SMBUS_Transfer.I2CM_Callback = 0;
+
+    return I2CM_Transfer(&SMBUS_Transfer);
+}
+
+/**
+ * @brief   Writes a block: command, count and data, with PEC if enabled.
+ * @return  a value of @ref I2CM_status.
+ */
+static uint8_t SMBUS_Block(uint8_t Address, uint8_t Command, const uint8_t *Data, uint8_t Length, uint8_t Flags) {
+    uint8_t i;
+
+    if(Length > SMBUS_BlockMax) {
+        Length = SMBUS_BlockMax;
+    }
+    SMBUS_TxBuffer[0] = Command;
+    SMBUS_TxBuffer[1] = Length;
+    for(i = 0; i < Length; i++) {
+        SMBUS_TxBuffer[2 + i] = Data[i];
+    }
+    return SMBUS_Run(Address, (uint16_t)(2 + Length), 0, Flags);
+}
+
+/**
+ * @brief   Initializes I2C1 for SMBus: sets the SMBus mode bits of the
+ *        running peripheral and selects the PEC of the current byte,
+ *        which I2CM uses for its PEC handling.
+ *          I2C_Init() and, for the host role, I2CM_Init() must have been
+ *        called. The host helpers below are blocking and return the I2CM
+ *        status; they must not run while I2CQ owns the engine. A device
+ *        serves its commands with I2CSLV.
+ *          The PEC is generated and checked by the peripheral, so a
+ *        mismatch ends the read with I2CM_Status_PECError and is counted
+ *        in the I2CM error counters.
+ * @param   SMBUS_InitStruct - pointer to a SMBUS_InitTypeDef structure.
+ * @return  none
+ */
+void SMBUS_Init(SMBUS_InitTypeDef *SMBUS_InitStruct) {
+    uint16_t tmpreg = I2C1->CTLR1;
+
+    tmpreg |= I2C_CTLR1_SMBUS;
+    if(SMBUS_InitStruct->SMBUS_Type == SMBUS_Type_Host) {
+        tmpreg |= I2C_CTLR1_SMBTYPE;
+    }
+    else {
+        tmpreg &= (uint16_t)~I2C_CTLR1_SMBTYPE;
+    }
+    I2C1->CTLR1 = tmpreg;
+
+    I2C_PECPositionConfig(I2C1, I2C_PECPosition_Current);
+    SMBUS_PECCmd(SMBUS_InitStruct->SMBUS_PEC);
+    SMBUS_ARPCmd(SMBUS_InitStruct->SMBUS_ARP);
+}
+
+/**
+ * @brief   Fills each SMBUS_InitStruct member with its default value.
+ * @param   SMBUS_InitStruct - pointer to a SMBUS_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void SMBUS_StructInit(SMBUS_InitTypeDef *SMBUS_InitStruct) {
+    SMBUS_InitStruct->SMBUS_Type = SMBUS_Type_Host;
+    SMBUS_InitStruct->SMBUS_PEC = ENABLE;
+    SMBUS_InitStruct->SMBUS_ARP = DISABLE;
+}
+
+/**
+ * @brief   Enables or disables PEC on the host helpers. ARP always uses
+ *        PEC.
+ * @param   NewState - ENABLE or DISABLE.
+ * @return  none
+ */
+void SMBUS_PECCmd(FunctionalState NewState) {
+    SMBUS_Flags = (NewState != DISABLE) ? I2CM_Flag_PEC : I2CM_Flag_None;
+}
+
+/**
+ * @brief   Enables or disables ARP address recognition.
+ * @param   NewState - ENABLE or DISABLE.
+ * @return  none
+ */
+void SMBUS_ARPCmd(FunctionalState NewState) {
+    I2C_ARPCmd(I2C1, NewState);
+}
+
+/**
+ * @brief   Reads the PEC register: after a transfer it holds the PEC
+ *        computed over it, for logging a mismatch.
+ * @return  the PEC value.
+ */
+uint8_t SMBUS_GetPEC(void) {
+    return I2C_GetPEC(I2C1);
+}
+
+/**
+ * @brief   Send Byte: a command without data, e.g. PMBus CLEAR_FAULTS.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_SendByte(uint8_t Address, uint8_t Command) {
+    SMBUS_TxBuffer[0] = Command;
+    return SMBUS_Run(Address, 1, 0, I2CM_Flag_None);
+}
+
+/**
+ * @brief   Write Byte.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - byte to write.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_WriteByte(uint8_t Address, uint8_t Command, uint8_t Data) {
+    SMBUS_TxBuffer[0] = Command;
+    SMBUS_TxBuffer[1] = Data;
+    return SMBUS_Run(Address, 2, 0, I2CM_Flag_None);
+}
+
+/**
+ * @brief   Read Byte.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - receives the byte, written only on success.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_ReadByte(uint8_t Address, uint8_t Command, uint8_t *Data) {
+    uint8_t status;
+
+    SMBUS_TxBuffer[0] = Command;
+    status = SMBUS_Run(Address, 1, 1, I2CM_Flag_None);
+    if(status == I2CM_Status_Done) {
+        *Data = SMBUS_RxBuffer[0];
+    }
+    return status;
+}
+
+/**
+ * @brief   Write Word, low byte first.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - word to write.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_WriteWord(uint8_t Address, uint8_t Command, uint16_t Data) {
+    SMBUS_TxBuffer[0] = Command;
+    SMBUS_TxBuffer[1] = (uint8_t)Data;
+    SMBUS_TxBuffer[2] = (uint8_t)(Data >> 8);
+    return SMBUS_Run(Address, 3, 0, I2CM_Flag_None);
+}
+
+/**
+ * @brief   Read Word, low byte first.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - receives the word, written only on success.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_ReadWord(uint8_t Address, uint8_t Command, uint16_t *Data) {
+    uint8_t status;
+
+    SMBUS_TxBuffer[0] = Command;
+    status = SMBUS_Run(Address, 1, 2, I2CM_Flag_None);
+    if(status == I2CM_Status_Done) {
+        *Data = (uint16_t)(SMBUS_RxBuffer[0] | ((uint16_t)SMBUS_RxBuffer[1] << 8));
+    }
+    return status;
+}
+
+/**
+ * @brief   Block Write of up to SMBUS_BlockMax bytes.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - bytes to write.
+ *          Length - number of bytes, longer blocks are cut.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_BlockWrite(uint8_t Address, uint8_t Command, const uint8_t *Data, uint8_t Length) {
+    return SMBUS_Block(Address, Command, Data, Length, I2CM_Flag_None);
+}
+
+/**
+ * @brief   Block Read. The count sent by the slave sets the read length
+ *        on the fly; a count larger than the buffer is cut to it and a
+ *        count of 0 reads one byte, so the transfer always ends cleanly.
+ * @param   Address - 7-bit slave address.
+ *          Command - command code.
+ *          Data - receives the block.
+ *          Length - in: size of Data, at most SMBUS_BlockMax.
+ *                   out: bytes received.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_BlockRead(uint8_t Address, uint8_t Command, uint8_t *Data, uint8_t *Length) {
+    uint8_t status, count, i;
+    uint8_t size = (*Length > SMBUS_BlockMax) ? SMBUS_BlockMax : *Length;
+    uint8_t pec = (SMBUS_Flags & I2CM_Flag_PEC) ? 1 : 0;
+
+    *Length = 0;
+    if(size == 0) {
+        return I2CM_Status_Error;
+    }
+    SMBUS_TxBuffer[0] = Command;
+    status = SMBUS_Run(Address, 1, (uint16_t)(1 + size + pec), I2CM_Flag_Block);
+    if(status == I2CM_Status_Done) {
+        count = (uint8_t)(SMBUS_Transfer.I2CM_Received - 1 - pec);
+        for(i = 0; i < count; i++) {
+            Data[i] = SMBUS_RxBuffer[1 + i];
+        }
+        *Length = count;
+    }
+    return status;
+}
+
+/**
+ * @brief   ARP Prepare to ARP, sent to all devices.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_ARPPrepare(void) {
+    SMBUS_TxBuffer[0] = SMBUS_ARP_CMD_Prepare;
+    return SMBUS_Run(SMBUS_ARP_Address, 1, 0, I2CM_Flag_PEC);
+}
+
+/**
+ * @brief   ARP Reset Device, general form: all devices without a fixed
+ *        address drop the address they were assigned.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_ARPReset(void) {
+    SMBUS_TxBuffer[0] = SMBUS_ARP_CMD_Reset;
+    return SMBUS_Run(SMBUS_ARP_Address, 1, 0, I2CM_Flag_PEC);
+}
+
+/**
+ * @brief   ARP Get UDID, general form. Arbitration among the devices is
+ *        done on the bus, so the answer comes from the device with the
+ *        lowest UDID; it stops answering once it is assigned an address.
+ * @param   UDID - receives the SMBUS_ARP_UDIDLength byte UDID.
+ *          Address - receives the current device address, 0x7F if none.
+ * @return  a value of @ref I2CM_status, I2CM_Status_Nack once every
+ *        device has an address.
+ */
+uint8_t SMBUS_ARPGetUDID(uint8_t *UDID, uint8_t *Address) {
+    uint8_t status, i;
+
+    SMBUS_TxBuffer[0] = SMBUS_ARP_CMD_GetUDID;
+    status = SMBUS_Run(SMBUS_ARP_Address, 1, 1 + SMBUS_ARP_UDIDLength + 1 + 1, I2CM_Flag_PEC | I2CM_Flag_Block);
+    if(status != I2CM_Status_Done) {
+        return status;
+    }
+    if(SMBUS_RxBuffer[0] != SMBUS_ARP_UDIDLength + 1) {
+        return I2CM_Status_Error;
+    }
+    for(i = 0; i < SMBUS_ARP_UDIDLength; i++) {
+        UDID[i] = SMBUS_RxBuffer[1 + i];
+    }
+    *Address = SMBUS_RxBuffer[1 + SMBUS_ARP_UDIDLength] >> 1;
+    return status;
+}
+
+/**
+ * @brief   ARP Assign Address to the device with the given UDID.
+ * @param   UDID - SMBUS_ARP_UDIDLength byte UDID from SMBUS_ARPGetUDID().
+ *          Address - 7-bit address to assign.
+ * @return  a value of @ref I2CM_status.
+ */
+uint8_t SMBUS_ARPAssign(const uint8_t *UDID, uint8_t Address) {
+    uint8_t data[SMBUS_ARP_UDIDLength + 1];
+    uint8_t i;
+
+    for(i = 0; i < SMBUS_ARP_UDIDLength; i++) {
+        data[i] = UDID[i];
+    }
+    data[SMBUS_ARP_UDIDLength] = (uint8_t)((Address << 1) | 0x01);
+    return SMBUS_Block(SMBUS_ARP_Address, SMBUS_ARP_CMD_Assign, data, sizeof(data), I2CM_Flag_PEC);
+}
+
+/**
+ * @brief   Converts a PMBus LINEAR11 value (5-bit exponent, 11-bit
+ *        mantissa, both signed) to fixed point. Shifts only.
+ * @param   Raw - LINEAR11 word.
+ *          Frac - fractional bits of the result.
+ * @return  the value times 2^Frac, rounded down.
+ */
+int32_t SMBUS_Linear11ToFixed(uint16_t Raw, uint8_t Frac) {
+    int8_t  shift = (int8_t)(((int16_t)Raw >> 11) + Frac);
+    int32_t mantissa = (int16_t)(Raw << 5) >> 5;
+
+    if(shift >= 0) {
+        return (int32_t)((uint32_t)mantissa << shift);
+    }
+    return mantissa >> -shift;
+}
+
+/**
+ * @brief   Converts a fixed point value to PMBus LINEAR11, with the
+ *        smallest exponent that holds it, rounding half up. Shifts only.
+ * @param   Value - value times 2^Frac.
+ *          Frac - fractional bits of Value.
+ * @return  the LINEAR11 word, saturated.
+ */
+uint16_t SMBUS_FixedToLinear11(int32_t Value, uint8_t Frac) {
+    int8_t  exponent = (int8_t)-Frac;
+    int32_t mantissa = Value;
+    uint8_t shift = 0;
+
+    /* Find the exponent on the truncated value, then round once */
+    while((mantissa > 1023) || (mantissa < -1024) || (exponent < -16)) {
+        mantissa >>= 1;
+        exponent++;
+        shift++;
+    }
+    if(shift != 0) {
+        mantissa = (Value >> shift) + ((Value >> (shift - 1)) & 0x01);
+        if(mantissa > 1023) {
+            mantissa >>= 1;
+            exponent++;
+        }
+    }
+    if(exponent > 15) {
+        mantissa = (mantissa < 0) ? -1024 : 1023;
+        exponent = 15;
+    }
+    return (uint16_t)(((uint16_t)(exponent & 0x1F) << 11) | (uint16_t)(mantissa & 0x7FF));
+}
+
+/**
+ * @brief   Converts a PMBus LINEAR16 value (VOUT) to fixed point.
+ * @param   Raw - unsigned mantissa.
+ *          Mode - VOUT_MODE byte, its low 5 bits are the signed exponent.
+ *          Frac - fractional bits of the result.
+ * @return  the value times 2^Frac, rounded down.
+ */
+uint32_t SMBUS_Linear16ToFixed(uint16_t Raw, uint8_t Mode, uint8_t Frac) {
+    int8_t shift = (int8_t)(((int8_t)(Mode << 3) >> 3) + Frac);
+
+    if(shift >= 0) {
+        return (uint32_t)Raw << shift;
+    }
+    return (uint32_t)Raw >> -shift;
+}
+
+/**
+ * @brief   Converts a fixed point value to PMBus LINEAR16, rounding half
+ *        up.
+ * @param   Value - value times 2^Frac.
+ *          Mode - VOUT_MODE byte, its low 5 bits are the signed exponent.
+ *          Frac - fractional bits of Value.
+ * @return  the mantissa, saturated at 0xFFFF.
+ */
+uint16_t SMBUS_FixedToLinear16(uint32_t Value, uint8_t Mode, uint8_t Frac) {
+    int8_t shift = (int8_t)(((int8_t)(Mode << 3) >> 3) + Frac);
+
+    if(shift > 0) {
+        Value = (Value >> shift) + ((Value >> (shift - 1)) & 0x01);
+    }
+    else if(shift < 0) {
+        if(Value > ((uint32_t)0xFFFF >> -shift)) {
+            return 0xFFFF;
+        }
+        Value <<= -shift;
+    }
+    return (Value > 0xFFFF) ? 0xFFFF : (uint16_t)Value;
+}
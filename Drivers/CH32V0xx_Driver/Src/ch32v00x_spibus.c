@@ -0,0 +1,288 @@
+#include "ch32v00x_spibus.h"
+#include "ch32v00x_dma.h"
+
+/* SPI1 DMA channels */
+#define SPIBUS_RX_DMA_Channel    DMA1_Channel2
+#define SPIBUS_TX_DMA_Channel    DMA1_Channel3
+
+static SPIBUS_TransactionTypeDef *SPIBUS_Head = 0;
+static SPIBUS_TransactionTypeDef *SPIBUS_Tail = 0;
+static volatile uint8_t SPIBUS_Busy = 0;
+
+/* CTLR1 currently loaded into SPI1, to skip reconfiguration for the same device */
+static uint16_t SPIBUS_CTLR1 = 0;
+
+/* DMA channel configurations without MINC and EN */
+static uint16_t SPIBUS_RxCfg = 0;
+static uint16_t SPIBUS_TxCfg = 0;
+
+/* Sources and sinks for transactions without TX or RX data, wide enough for 16-bit frames */
+static const uint16_t SPIBUS_Fill = (SPIBUS_FillByte << 8) | SPIBUS_FillByte;
+static uint16_t       SPIBUS_Discard;
+
+/**
+ * @brief   Loads the device configuration, asserts chip select and starts
+ *        both DMA channels. RX is enabled first so no frame is missed.
+ *          16-bit transactions set DFF in the CTLR1 value being loaded
+ *        (the SPI_DataSizeConfig() setting) and switch both channels to
+ *        half-word transfers, halving the DMA request count.
+ * @param   Transaction - transaction at the head of the queue.
+ * @return  none
+ */
+static void SPIBUS_Start(SPIBUS_TransactionTypeDef *Transaction) {
+    SPIBUS_DeviceTypeDef *device = Transaction->SPIBUS_Device;
+    uint16_t              ctlr1 = device->SPIBUS_CTLR1;
+    uint16_t              rxcfg = SPIBUS_RxCfg;
+    uint16_t              txcfg = SPIBUS_TxCfg;
+
+    if(Transaction->SPIBUS_Flags & SPIBUS_Flag_16Bit) {
+        ctlr1 |= SPI_DataSize_16b;
+        rxcfg |= (uint16_t)(DMA_PeripheralDataSize_HalfWord | DMA_MemoryDataSize_HalfWord);
+        txcfg |= (uint16_t)(DMA_PeripheralDataSize_HalfWord | DMA_MemoryDataSize_HalfWord);
+    }
+
+    /* The frame format may only change while the SPI is disabled */
+    if(ctlr1 != SPIBUS_CTLR1) {
+        SPIBUS_CTLR1 = ctlr1;
+        SPI1->CTLR1 = ctlr1 & (uint16_t)~SPI_CTLR1_SPE;
+        SPI1->CTLR1 = ctlr1;
+    }
+    (void)SPI1->DATAR;
+
+    if(device->SPIBUS_CSPort != 0) {
+        device->SPIBUS_CSPort->BCR = device->SPIBUS_CSPin;
+    }
+
+    if(Transaction->SPIBUS_RxData != 0) {
+        SPIBUS_RX_DMA_Channel->CFGR = rxcfg | DMA_CFGR1_MINC;
+        SPIBUS_RX_DMA_Channel->MADDR = (uint32_t)Transaction->SPIBUS_RxData;
+    }
+    else {
+        SPIBUS_RX_DMA_Channel->CFGR = rxcfg;
+        SPIBUS_RX_DMA_Channel->MADDR = (uint32_t)&SPIBUS_Discard;
+    }
+    if(Transaction->SPIBUS_TxData == 0) {
+        SPIBUS_TX_DMA_Channel->CFGR = txcfg;
+        SPIBUS_TX_DMA_Channel->MADDR = (uint32_t)&SPIBUS_Fill;
+    }
+    else if(Transaction->SPIBUS_Flags & SPIBUS_Flag_Fill) {
+        /* Repeat one source frame: memory increment stays off */
+        SPIBUS_TX_DMA_Channel->CFGR = txcfg;
+        SPIBUS_TX_DMA_Channel->MADDR = (uint32_t)Transaction->SPIBUS_TxData;
+    }
+    else {
+        SPIBUS_TX_DMA_Channel->CFGR = txcfg | DMA_CFGR1_MINC;
+        SPIBUS_TX_DMA_Channel->MADDR = (uint32_t)Transaction->SPIBUS_TxData;
+    }
+    SPIBUS_RX_DMA_Channel->CNTR = Transaction->SPIBUS_Length;
+    SPIBUS_TX_DMA_Channel->CNTR = Transaction->SPIBUS_Length;
+
+    SPIBUS_RX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+    SPIBUS_TX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+}
+
+/**
+ * @brief   Initializes DMA1 channels 2 (RX) and 3 (TX) for queued SPI1
+ *        transactions.
+ *          Peripheral clocks, the SCK/MOSI/MISO pins and the
+ *        DMA1_Channel2 NVIC channel must be configured by the
+ *        application, which also has to call SPIBUS_IRQHandler() from
+ *        DMA1_Channel2_IRQHandler(). Chip select pins are set up by
+ *        SPIBUS_DeviceInit() but must already be push-pull outputs.
+ * @return  none
+ */
+void SPIBUS_Init(void) {
+    DMA_InitTypeDef DMA_InitStructure;
+
+    SPIBUS_Head = 0;
+    SPIBUS_Tail = 0;
+    SPIBUS_Busy = 0;
+    SPIBUS_CTLR1 = 0;
+
+    DMA_DeInit(SPIBUS_RX_DMA_Channel);
+    DMA_DeInit(SPIBUS_TX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&SPI1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(SPIBUS_RX_DMA_Channel, &DMA_InitStructure);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_Init(SPIBUS_TX_DMA_Channel, &DMA_InitStructure);
+
+    /* Completion is signalled by RX, which finishes after the last TX byte */
+    DMA_ITConfig(SPIBUS_RX_DMA_Channel, DMA_IT_TC, ENABLE);
+    SPIBUS_RxCfg = (uint16_t)SPIBUS_RX_DMA_Channel->CFGR;
+    SPIBUS_TxCfg = (uint16_t)SPIBUS_TX_DMA_Channel->CFGR;
+
+    SPI_I2S_DMACmd(SPI1, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, ENABLE);
+}
+
+/**
+ * @brief   Prepares a device descriptor: the CTLR1 value for SPI1 is built
+ *        once from SPI_InitStruct so switching devices later costs a
+ *        register write instead of a full SPI_Init().
+ *          The engine always runs as a full-duplex master with software
+ *        NSS, so those members of SPI_InitStruct are ignored.
+ * @param   Device - descriptor to fill.
+ *          SPI_InitStruct - mode, data size, clock and bit order.
+ *          CSPort - GPIO port of the chip select pin, 0 if unused.
+ *          CSPin - chip select pin, driven high here.
+ * @return  none
+ */
+void SPIBUS_DeviceInit(SPIBUS_DeviceTypeDef *Device, SPI_InitTypeDef *SPI_InitStruct,
+                       GPIO_TypeDef *CSPort, uint16_t CSPin) {
+    Device->SPIBUS_CTLR1 = (uint16_t)(SPI_Direction_2Lines_FullDuplex | SPI_Mode_Master | SPI_NSS_Soft |
+                                      SPI_CTLR1_SSI | SPI_CTLR1_SPE | SPI_InitStruct->SPI_DataSize |
+                                      SPI_InitStruct->SPI_CPOL | SPI_InitStruct->SPI_CPHA |
+                                      SPI_InitStruct->SPI_BaudRatePrescaler | SPI_InitStruct->SPI_FirstBit);
+    Device->SPIBUS_CSPort = CSPort;
+    Device->SPIBUS_CSPin = CSPin;
+    if(CSPort != 0) {
+        CSPort->BSHR = CSPin;
+    }
+}
+
+/**
+ * @brief   Queues a transaction; it is started immediately when the bus
+ *        is idle. Can be called from a completion callback.
+ *          The transaction must stay valid until its status is
+ *        SPIBUS_Status_Done.
+ * @param   Transaction - transaction to queue.
+ * @return  READY if queued, NoREADY if it has no device or zero length.
+ */
+ErrorStatus SPIBUS_Submit(SPIBUS_TransactionTypeDef *Transaction) {
+    uint32_t mstatus;
+
+    if((Transaction->SPIBUS_Device == 0) || (Transaction->SPIBUS_Length == 0)) {
+        return NoREADY;
+    }
+    Transaction->SPIBUS_Status = SPIBUS_Status_Pending;
+    Transaction->SPIBUS_Next = 0;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    if(SPIBUS_Tail != 0) {
+        SPIBUS_Tail->SPIBUS_Next = Transaction;
+    }
+    else {
+        SPIBUS_Head = Transaction;
+    }
+    SPIBUS_Tail = Transaction;
+    if(!SPIBUS_Busy) {
+        SPIBUS_Busy = 1;
+        SPIBUS_Start(Transaction);
+    }
+    __set_MSTATUS(mstatus);
+
+    return READY;
+}
+
+/**
+ * @brief   Queues a transaction and waits for it to complete. Must not be
+ *        called from interrupt context.
+ * @param   Transaction - transaction to run.
+ * @return  READY once done, NoREADY if it was rejected.
+ */
+ErrorStatus SPIBUS_Transfer(SPIBUS_TransactionTypeDef *Transaction) {
+    if(SPIBUS_Submit(Transaction) != READY) {
+        return NoREADY;
+    }
+    while(Transaction->SPIBUS_Status != SPIBUS_Status_Done)
+        ;
+    return READY;
+}
+
+/**
+ * @brief   Streams 16-bit frames (pixels, DAC codes) with half-word DMA.
+ *          The transaction is filled in and queued; RX data is discarded
+ *        and SPIBUS_Callback is left as set by the caller.
+ * @param   Transaction - transaction to fill, must stay valid until done.
+ *          Device - target device.
+ *          Data - half-words to send, MSB first on the wire.
+ *          Count - number of half-words.
+ *          Flags - extra @ref SPIBUS_flags, e.g. SPIBUS_Flag_HoldCS.
+ * @return  READY if queued, NoREADY otherwise.
+ */
+ErrorStatus SPIBUS_Write16(SPIBUS_TransactionTypeDef *Transaction, SPIBUS_DeviceTypeDef *Device,
+                           const uint16_t *Data, uint16_t Count, uint8_t Flags) {
+    Transaction->SPIBUS_Device = Device;
+    Transaction->SPIBUS_TxData = (const uint8_t *)Data;
+    Transaction->SPIBUS_RxData = 0;
+    Transaction->SPIBUS_Length = Count;
+    Transaction->SPIBUS_Flags = Flags | SPIBUS_Flag_16Bit;
+    return SPIBUS_Submit(Transaction);
+}
+
+/**
+ * @brief   Sends the same 16-bit frame Count times (solid colour fill)
+ *        from a single source word with memory increment disabled.
+ * @param   Transaction - transaction to fill, must stay valid until done.
+ *          Device - target device.
+ *          Value - frame to repeat, must stay valid until done.
+ *          Count - number of frames.
+ *          Flags - extra @ref SPIBUS_flags, e.g. SPIBUS_Flag_HoldCS.
+ * @return  READY if queued, NoREADY otherwise.
+ */
+ErrorStatus SPIBUS_Fill16(SPIBUS_TransactionTypeDef *Transaction, SPIBUS_DeviceTypeDef *Device,
+                          const uint16_t *Value, uint16_t Count, uint8_t Flags) {
+    Transaction->SPIBUS_Device = Device;
+    Transaction->SPIBUS_TxData = (const uint8_t *)Value;
+    Transaction->SPIBUS_RxData = 0;
+    Transaction->SPIBUS_Length = Count;
+    Transaction->SPIBUS_Flags = Flags | SPIBUS_Flag_16Bit | SPIBUS_Flag_Fill;
+    return SPIBUS_Submit(Transaction);
+}
+
+/**
+ * @brief   Checks whether a transaction is in progress or queued.
+ * @return  SET while the engine is busy, RESET when idle.
+ */
+FlagStatus SPIBUS_GetBusy(void) {
+    return SPIBUS_Busy ? SET : RESET;
+}
+
+/**
+ * @brief   Completes the active transaction on DMA1 channel 2 transfer
+ *        complete, runs its callback and starts the next one.
+ * @return  none
+ */
+void SPIBUS_IRQHandler(void) {
+    SPIBUS_TransactionTypeDef *done = SPIBUS_Head;
+    SPIBUS_DeviceTypeDef      *device;
+
+    if(((DMA1->INTFR & DMA1_FLAG_TC2) == 0) || (done == 0)) {
+        return;
+    }
+    DMA1->INTFCR = DMA1_FLAG_GL2 | DMA1_FLAG_GL3;
+    SPIBUS_TX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+    SPIBUS_RX_DMA_Channel->CFGR &= (uint16_t)(~DMA_CFGR1_EN);
+
+    device = done->SPIBUS_Device;
+    if(((done->SPIBUS_Flags & SPIBUS_Flag_HoldCS) == 0) && (device->SPIBUS_CSPort != 0)) {
+        device->SPIBUS_CSPort->BSHR = device->SPIBUS_CSPin;
+    }
+
+    SPIBUS_Head = done->SPIBUS_Next;
+    if(SPIBUS_Head == 0) {
+        SPIBUS_Tail = 0;
+    }
+    done->SPIBUS_Status = SPIBUS_Status_Done;
+    if(done->SPIBUS_Callback != 0) {
+        done->SPIBUS_Callback(done);
+    }
+
+    if(SPIBUS_Head != 0) {
+        SPIBUS_Start(SPIBUS_Head);
+    }
+    else {
+        SPIBUS_Busy = 0;
+    }
+}
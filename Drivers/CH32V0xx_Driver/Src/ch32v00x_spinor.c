@@ -0,0 +1,296 @@
+#include "ch32v00x_spinor.h"
+#include "ch32v00x_spibus.h"
+
+/* Status polls before a program or erase is considered hung */
+#define SPINOR_Timeout           ((uint32_t)0x00100000)
+
+/* Tag of an empty cache line */
+#define SPINOR_TagInvalid        ((uint32_t)0xFFFFFFFF)
+
+static SPIBUS_DeviceTypeDef      SPINOR_Device;
+static SPIBUS_TransactionTypeDef SPINOR_TrWren;
+static SPIBUS_TransactionTypeDef SPINOR_TrCmd;
+static SPIBUS_TransactionTypeDef SPINOR_TrData;
+
+static const uint8_t SPINOR_Wren = SPINOR_CMD_WriteEnable;
+static uint8_t       SPINOR_Cmd[5];
+static uint8_t       SPINOR_Rsp[4];
+static uint32_t      SPINOR_Size = 0;
+static uint8_t       SPINOR_Busy = 0;
+
+static uint32_t SPINOR_Tags[SPINOR_CacheLines];
+static uint8_t  SPINOR_Cache[SPINOR_CacheLines][SPINOR_CacheLineSize];
+
+static void SPINOR_Queue(SPIBUS_TransactionTypeDef *Transaction, const uint8_t *TxData, uint8_t *RxData,
+                         uint16_t Length, uint8_t Flags) {
+    Transaction->SPIBUS_Device = &SPINOR_Device;
+    Transaction->SPIBUS_TxData = TxData;
+    Transaction->SPIBUS_RxData = RxData;
+    Transaction->SPIBUS_Length = Length;
+    Transaction->SPIBUS_Flags = Flags;
+    Transaction->SPIBUS_Callback = 0;
+    SPIBUS_Submit(Transaction);
+}
+
+static void SPINOR_Wait(SPIBUS_TransactionTypeDef *Transaction) {
+    while(Transaction->SPIBUS_Status != SPIBUS_Status_Done)
+        ;
+}
+
+static void SPINOR_SetCommand(uint8_t Command, uint32_t Address) {
+    SPINOR_Cmd[0] = Command;
+    SPINOR_Cmd[1] = (uint8_t)(Address >> 16);
+    SPINOR_Cmd[2] = (uint8_t)(Address >> 8);
+    SPINOR_Cmd[3] = (uint8_t)Address;
+    SPINOR_Cmd[4] = 0xFF;
+}
+
+/**
+ * @brief   Reads with the fast read command straight into Data: the
+ *        command and the data phase are queued back to back under one
+ *        chip select.
+ * @param   Address - flash address.
+ *          Data - destination buffer.
+ *          Length - number of bytes.
+ * @return  none
+ */
+static void SPINOR_FastRead(uint32_t Address, uint8_t *Data, uint16_t Length) {
+    SPINOR_SetCommand(SPINOR_CMD_FastRead, Address);
+    SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, 0, 5, SPIBUS_Flag_HoldCS);
+    SPINOR_Queue(&SPINOR_TrData, 0, Data, Length, SPIBUS_Flag_None);
+    SPINOR_Wait(&SPINOR_TrData);
+}
+
+/**
+ * @brief   Drops cached lines overlapping [Address, Address + Length).
+ * @return  none
+ */
+static void SPINOR_Invalidate(uint32_t Address, uint32_t Length) {
+    uint32_t start = Address & ~(uint32_t)(SPINOR_CacheLineSize - 1);
+    uint8_t  i;
+
+    for(i = 0; i < SPINOR_CacheLines; i++) {
+        if((SPINOR_Tags[i] >= start) && (SPINOR_Tags[i] < Address + Length)) {
+            SPINOR_Tags[i] = SPINOR_TagInvalid;
+        }
+    }
+}
+
+/**
+ * @brief   Initializes the 25-series SPI NOR driver on the SPI1 DMA engine
+ *        and probes the device with its JEDEC ID.
+ *          SPIBUS_Init() must have been called, and the chip select pin
+ *        configured as a push-pull output by the application.
+ * @param   SPINOR_InitStruct - pointer to a SPINOR_InitTypeDef structure.
+ * @return  none
+ */
+void SPINOR_Init(SPINOR_InitTypeDef *SPINOR_InitStruct) {
+    SPI_InitTypeDef SPI_InitStructure;
+    uint32_t        id;
+    uint8_t         capacity;
+
+    SPI_StructInit(&SPI_InitStructure);
+    SPI_InitStructure.SPI_BaudRatePrescaler = SPINOR_InitStruct->SPINOR_BaudRatePrescaler;
+    SPIBUS_DeviceInit(&SPINOR_Device, &SPI_InitStructure, SPINOR_InitStruct->SPINOR_CSPort,
+                      SPINOR_InitStruct->SPINOR_CSPin);
+
+    SPINOR_InvalidateCache();
+
+    /* Wake the part in case it was left in deep power-down */
+    SPINOR_Cmd[0] = SPINOR_CMD_ReleasePowerDown;
+    SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, 0, 1, SPIBUS_Flag_None);
+    SPINOR_Wait(&SPINOR_TrCmd);
+
+    /* A part still programming from before reset may not answer yet */
+    id = SPINOR_ReadJedecId();
+    if((id == 0) || (id == 0xFFFFFF)) {
+        SPINOR_Busy = 1;
+        SPINOR_WaitReady();
+        id = SPINOR_ReadJedecId();
+    }
+
+    capacity = (uint8_t)id;
+    SPINOR_Size = ((capacity >= 0x10) && (capacity <= 0x18)) ? ((uint32_t)1 << capacity) : 0;
+}
+
+/**
+ * @brief   Fills each SPINOR_InitStruct member with its default value.
+ * @param   SPINOR_InitStruct - pointer to a SPINOR_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void SPINOR_StructInit(SPINOR_InitTypeDef *SPINOR_InitStruct) {
+    SPINOR_InitStruct->SPINOR_CSPort = 0;
+    SPINOR_InitStruct->SPINOR_CSPin = 0;
+    SPINOR_InitStruct->SPINOR_BaudRatePrescaler = SPI_BaudRatePrescaler_2;
+}
+
+/**
+ * @brief   Reads the JEDEC manufacturer and device ID.
+ * @return  manufacturer (bits 23:16), memory type (15:8) and capacity
+ *        (7:0); 0 or 0xFFFFFF when no device answers.
+ */
+uint32_t SPINOR_ReadJedecId(void) {
+    SPINOR_Cmd[0] = SPINOR_CMD_JedecId;
+    SPINOR_Cmd[1] = 0xFF;
+    SPINOR_Cmd[2] = 0xFF;
+    SPINOR_Cmd[3] = 0xFF;
+    SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, SPINOR_Rsp, 4, SPIBUS_Flag_None);
+    SPINOR_Wait(&SPINOR_TrCmd);
+
+    return ((uint32_t)SPINOR_Rsp[1] << 16) | ((uint32_t)SPINOR_Rsp[2] << 8) | SPINOR_Rsp[3];
+}
+
+/**
+ * @brief   Returns the device size decoded from the JEDEC ID.
+ * @return  size in bytes, 0 if no supported device was found.
+ */
+uint32_t SPINOR_GetSize(void) {
+    return SPINOR_Size;
+}
+
+/**
+ * @brief   Polls the status register until the last program or erase has
+ *        finished. Returns at once when nothing is outstanding.
+ * @return  READY when the device is idle, NoREADY on timeout.
+ */
+ErrorStatus SPINOR_WaitReady(void) {
+    uint32_t polls = SPINOR_Timeout;
+
+    while(SPINOR_Busy) {
+        SPINOR_Cmd[0] = SPINOR_CMD_ReadStatus;
+        SPINOR_Cmd[1] = 0xFF;
+        SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, SPINOR_Rsp, 2, SPIBUS_Flag_None);
+        SPINOR_Wait(&SPINOR_TrCmd);
+        if((SPINOR_Rsp[1] & SPINOR_Status_WIP) == 0) {
+            SPINOR_Busy = 0;
+        }
+        else if(--polls == 0) {
+            return NoREADY;
+        }
+    }
+    return READY;
+}
+
+/**
+ * @brief   Reads from flash.
+ *          Small and unaligned reads go through a direct-mapped cache of
+ *        SPINOR_CacheLines lines; once the address is line aligned and at
+ *        least a full line remains, the rest is fetched directly by DMA
+ *        so bulk reads do not evict the cache.
+ * @param   Address - flash address.
+ *          Data - destination buffer.
+ *          Length - number of bytes.
+ * @return  READY on success, NoREADY if the device stayed busy.
+ */
+ErrorStatus SPINOR_Read(uint32_t Address, uint8_t *Data, uint16_t Length) {
+    uint32_t line;
+    uint16_t offset, chunk, i;
+    uint8_t  index;
+
+    if(SPINOR_WaitReady() != READY) {
+        return NoREADY;
+    }
+
+    while(Length != 0) {
+        offset = (uint16_t)(Address & (SPINOR_CacheLineSize - 1));
+        if((offset == 0) && (Length >= SPINOR_CacheLineSize)) {
+            SPINOR_FastRead(Address, Data, Length);
+            break;
+        }
+
+        line = Address - offset;
+        index = (uint8_t)((line / SPINOR_CacheLineSize) & (SPINOR_CacheLines - 1));
+        if(SPINOR_Tags[index] != line) {
+            SPINOR_FastRead(line, SPINOR_Cache[index], SPINOR_CacheLineSize);
+            SPINOR_Tags[index] = line;
+        }
+
+        chunk = SPINOR_CacheLineSize - offset;
+        if(chunk > Length) {
+            chunk = Length;
+        }
+        for(i = 0; i < chunk; i++) {
+            Data[i] = SPINOR_Cache[index][offset + i];
+        }
+        Address += chunk;
+        Data += chunk;
+        Length -= chunk;
+    }
+    return READY;
+}
+
+/**
+ * @brief   Programs flash, split at page boundaries. The target area must
+ *        have been erased.
+ *          Write enable, the program command and the data phase of a page
+ *        are queued back to back on the SPI engine. The call returns as
+ *        soon as the last page has been sent; its programming time
+ *        overlaps with whatever the caller does next, and the next
+ *        access waits for it through the status register.
+ * @param   Address - flash address.
+ *          Data - bytes to program.
+ *          Length - number of bytes.
+ * @return  READY on success, NoREADY if the device stayed busy.
+ */
+ErrorStatus SPINOR_Write(uint32_t Address, const uint8_t *Data, uint16_t Length) {
+    uint16_t chunk;
+
+    SPINOR_Invalidate(Address, Length);
+
+    while(Length != 0) {
+        chunk = SPINOR_PageSize - (uint16_t)(Address & (SPINOR_PageSize - 1));
+        if(chunk > Length) {
+            chunk = Length;
+        }
+        if(SPINOR_WaitReady() != READY) {
+            return NoREADY;
+        }
+
+        SPINOR_SetCommand(SPINOR_CMD_PageProgram, Address);
+        SPINOR_Queue(&SPINOR_TrWren, &SPINOR_Wren, 0, 1, SPIBUS_Flag_None);
+        SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, 0, 4, SPIBUS_Flag_HoldCS);
+        SPINOR_Queue(&SPINOR_TrData, Data, 0, chunk, SPIBUS_Flag_None);
+        SPINOR_Wait(&SPINOR_TrData);
+        SPINOR_Busy = 1;
+
+        Address += chunk;
+        Data += chunk;
+        Length -= chunk;
+    }
+    return READY;
+}
+
+/**
+ * @brief   Starts erasing the 4K sector containing Address and returns
+ *        without waiting for the erase to finish.
+ * @param   Address - any address inside the sector.
+ * @return  READY on success, NoREADY if the device stayed busy.
+ */
+ErrorStatus SPINOR_EraseSector(uint32_t Address) {
+    Address &= ~(SPINOR_SectorSize - 1);
+    SPINOR_Invalidate(Address, SPINOR_SectorSize);
+
+    if(SPINOR_WaitReady() != READY) {
+        return NoREADY;
+    }
+    SPINOR_SetCommand(SPINOR_CMD_SectorErase, Address);
+    SPINOR_Queue(&SPINOR_TrWren, &SPINOR_Wren, 0, 1, SPIBUS_Flag_None);
+    SPINOR_Queue(&SPINOR_TrCmd, SPINOR_Cmd, 0, 4, SPIBUS_Flag_None);
+    SPINOR_Wait(&SPINOR_TrCmd);
+    SPINOR_Busy = 1;
+    return READY;
+}
+
+/**
+ * @brief   Empties the read cache, e.g. after another master has written
+ *        the flash.
+ * @return  none
+ */
+void SPINOR_InvalidateCache(void) {
+    uint8_t i;
+
+    for(i = 0; i < SPINOR_CacheLines; i++) {
+        SPINOR_Tags[i] = SPINOR_TagInvalid;
+    }
+}
@@ -0,0 +1,294 @@
+#include "ch32v00x_spislv.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_gpio.h"
+#include "ch32v00x_spi.h"
+
+/* SPI1 DMA channels */
+#define SPISLV_RX_DMA_Channel    DMA1_Channel2
+#define SPISLV_TX_DMA_Channel    DMA1_Channel3
+
+/* Byte seen by the master while no response is loaded */
+#define SPISLV_IdleByte          ((uint8_t)0xFF)
+
+static uint8_t SPISLV_Ring[SPISLV_RingSize];
+
+/* Ring position after the last frame and total bytes received, both from the NSS handler */
+static uint16_t SPISLV_Head = 0;
+static uint32_t SPISLV_Total = 0;
+
+/* Received frames: start as a byte count (ring index in the low bits), payload length, status */
+static uint32_t         SPISLV_FrameStart[SPISLV_MaxFrames];
+static uint16_t         SPISLV_FrameLength[SPISLV_MaxFrames];
+static uint8_t          SPISLV_FrameStatus[SPISLV_MaxFrames];
+static volatile uint8_t SPISLV_FrameIn = 0;
+static volatile uint8_t SPISLV_FrameOut = 0;
+static volatile uint8_t SPISLV_Flush = 0;
+static uint16_t         SPISLV_Errors = 0;
+
+/* Response for the next frame and the one currently loaded into TX DMA */
+static const uint8_t *SPISLV_NextData = 0;
+static uint16_t       SPISLV_NextLength = 0;
+static uint16_t       SPISLV_TxLength = 0;
+
+static GPIO_TypeDef *SPISLV_NSSGpio = 0;
+static uint16_t      SPISLV_NSSMask = 0;
+static void (*SPISLV_Callback)(uint8_t Status) = 0;
+
+/**
+ * @brief   Re-arms SPI1 between frames: clears both CRC registers and
+ *        preloads the pending response into TX DMA, so the first byte
+ *        already sits in the data register when the master selects us.
+ *          Must only run while the slave is deselected.
+ * @return  none
+ */
+static void SPISLV_Load(void) {
+    SPI_Cmd(SPI1, DISABLE);
+    SPI_CalculateCRC(SPI1, DISABLE);
+    SPI_CalculateCRC(SPI1, ENABLE);
+    SPI_I2S_ClearFlag(SPI1, SPI_FLAG_CRCERR);
+
+    SPISLV_TX_DMA_Channel->CFGR &= (uint16_t)~DMA_CFGR1_EN;
+    SPISLV_TxLength = SPISLV_NextLength;
+    SPISLV_NextLength = 0;
+    if(SPISLV_TxLength != 0) {
+        SPISLV_TX_DMA_Channel->MADDR = (uint32_t)SPISLV_NextData;
+        SPISLV_TX_DMA_Channel->CNTR = SPISLV_TxLength;
+        SPISLV_TX_DMA_Channel->CFGR |= DMA_CFGR1_EN;
+    }
+    else {
+        SPI1->DATAR = SPISLV_IdleByte;
+    }
+    SPI_Cmd(SPI1, ENABLE);
+}
+
+/**
+ * @brief   Initializes SPI1 as a DMA driven slave. Frames are delimited by
+ *        the slave select pin and land back to back in a circular receive
+ *        ring (DMA1 channel 2), so the CPU only runs once per frame.
+ *          Each frame ends with a CRC-8 byte. Without a response loaded
+ *        the frame is accepted when the hardware RX CRC over all its bytes
+ *        is zero. With a response of N bytes loaded the master must clock
+ *        exactly N + 1 bytes: TX DMA (channel 3) sends the response, the
+ *        SPI appends its TX CRC and checks the master's CRC in the same
+ *        slot, reporting the result through the CRCERR flag.
+ *          NSS is managed in software: the select pin is watched by an
+ *        EXTI line on both edges and mirrored with
+ *        SPI_NSSInternalSoftwareConfig(), which frees the pin choice.
+ *          Peripheral clocks, the SCK/MOSI/MISO pins, the select pin as
+ *        an input with its EXTI line on both edges and the NVIC channel
+ *        are configured by the application, which calls
+ *        SPISLV_NSSHandler() from EXTI7_0_IRQHandler(). The master must
+ *        leave time for that interrupt after each select edge.
+ * @param   SPISLV_InitStruct - pointer to a SPISLV_InitTypeDef structure.
+ * @return  none
+ */
+void SPISLV_Init(SPISLV_InitTypeDef *SPISLV_InitStruct) {
+    SPI_InitTypeDef SPI_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+
+    SPISLV_NSSGpio = SPISLV_InitStruct->SPISLV_NSSPort;
+    SPISLV_NSSMask = SPISLV_InitStruct->SPISLV_NSSPin;
+    SPISLV_Callback = SPISLV_InitStruct->SPISLV_FrameCallback;
+    SPISLV_Head = 0;
+    SPISLV_Total = 0;
+    SPISLV_FrameIn = 0;
+    SPISLV_FrameOut = 0;
+    SPISLV_Flush = 0;
+    SPISLV_Errors = 0;
+    SPISLV_NextLength = 0;
+
+    SPI_InitStructure.SPI_Direction = SPI_Direction_2Lines_FullDuplex;
+    SPI_InitStructure.SPI_Mode = SPI_Mode_Slave;
+    SPI_InitStructure.SPI_DataSize = SPI_DataSize_8b;
+    SPI_InitStructure.SPI_CPOL = SPISLV_InitStruct->SPISLV_CPOL;
+    SPI_InitStructure.SPI_CPHA = SPISLV_InitStruct->SPISLV_CPHA;
+    SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;
+    SPI_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_2;
+    SPI_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;
+    SPI_InitStructure.SPI_CRCPolynomial = SPISLV_InitStruct->SPISLV_CRCPolynomial;
+    SPI_Init(SPI1, &SPI_InitStructure);
+    SPI_NSSInternalSoftwareConfig(SPI1, SPI_NSSInternalSoft_Set);
+
+    DMA_DeInit(SPISLV_RX_DMA_Channel);
+    DMA_DeInit(SPISLV_TX_DMA_Channel);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&SPI1->DATAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)SPISLV_Ring;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = SPISLV_RingSize;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(SPISLV_RX_DMA_Channel, &DMA_InitStructure);
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 0;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_Init(SPISLV_TX_DMA_Channel, &DMA_InitStructure);
+
+    SPI_I2S_DMACmd(SPI1, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, ENABLE);
+    DMA_Cmd(SPISLV_RX_DMA_Channel, ENABLE);
+    SPISLV_Load();
+}
+
+/**
+ * @brief   Fills each SPISLV_InitStruct member with its default value.
+ * @param   SPISLV_InitStruct - pointer to a SPISLV_InitTypeDef structure
+ *        which will be initialized.
+ * @return  none
+ */
+void SPISLV_StructInit(SPISLV_InitTypeDef *SPISLV_InitStruct) {
+    SPISLV_InitStruct->SPISLV_NSSPort = GPIOC;
+    SPISLV_InitStruct->SPISLV_NSSPin = GPIO_Pin_1;
+    SPISLV_InitStruct->SPISLV_CPOL = SPI_CPOL_Low;
+    SPISLV_InitStruct->SPISLV_CPHA = SPI_CPHA_1Edge;
+    SPISLV_InitStruct->SPISLV_CRCPolynomial = 0x07;
+    SPISLV_InitStruct->SPISLV_FrameCallback = 0;
+}
+
+/**
+ * @brief   Sets the response clocked out during the next frame. It is
+ *        loaded at once when the bus is idle, otherwise when the current
+ *        frame ends. A response is sent once; 0xFF is sent without one.
+ *          Can be called from the frame callback.
+ * @param   Data - response bytes, must stay valid until sent.
+ *          Length - number of bytes, 0 for none.
+ * @return  none
+ */
+void SPISLV_SetResponse(const uint8_t *Data, uint16_t Length) {
+    uint32_t mstatus;
+    uint16_t head;
+
+    mstatus = __get_MSTATUS();
+    __disable_irq();
+    SPISLV_NextData = Data;
+    SPISLV_NextLength = Length;
+
+    /* Bytes past the last frame mean a frame is in progress or its end is still pending */
+    head = (uint16_t)(SPISLV_RingSize - SPISLV_RX_DMA_Channel->CNTR) & (SPISLV_RingSize - 1);
+    if((head == SPISLV_Head) && (SPISLV_NSSGpio->INDR & SPISLV_NSSMask)) {
+        SPISLV_Load();
+    }
+    __set_MSTATUS(mstatus);
+}
+
+/**
+ * @brief   Copies out the oldest received frame without its CRC byte.
+ * @param   Data - destination buffer.
+ *          Length - buffer size on entry, payload length on return.
+ *            Longer payloads are truncated.
+ * @return  SPISLV_Status_None if no frame is waiting, otherwise the frame
+ *        status. SPISLV_Status_Overrun means unread frames were overwritten
+ *        in the ring and have all been discarded.
+ */
+uint8_t SPISLV_Receive(uint8_t *Data, uint16_t *Length) {
+    uint32_t mstatus, start;
+    uint16_t length, i;
+    uint8_t  slot, status;
+
+    if(SPISLV_FrameOut != SPISLV_FrameIn) {
+        slot = SPISLV_FrameOut & (SPISLV_MaxFrames - 1);
+        start = SPISLV_FrameStart[slot];
+        length = SPISLV_FrameLength[slot];
+        status = SPISLV_FrameStatus[slot];
+        if(length > *Length) {
+            length = *Length;
+        }
+        for(i = 0; i < length; i++) {
+            Data[i] = SPISLV_Ring[(uint16_t)(start + i) & (SPISLV_RingSize - 1)];
+        }
+        SPISLV_FrameOut++;
+        *Length = length;
+    }
+    else {
+        status = SPISLV_Status_None;
+        *Length = 0;
+    }
+
+    /* Checked after copying: the frame just read may have been overwritten too */
+    if(SPISLV_Flush) {
+        mstatus = __get_MSTATUS();
+        __disable_irq();
+        SPISLV_FrameOut = SPISLV_FrameIn;
+        SPISLV_Flush = 0;
+        __set_MSTATUS(mstatus);
+        status = SPISLV_Status_Overrun;
+        *Length = 0;
+    }
+    return status;
+}
+
+/**
+ * @brief   Returns the number of CRC failures and dropped frames since
+ *        SPISLV_Init().
+ * @return  error count.
+ */
+uint16_t SPISLV_GetErrorCount(void) {
+    return SPISLV_Errors;
+}
+
+/**
+ * @brief   Handles both edges of the slave select pin. The falling edge
+ *        selects the SPI; the rising edge closes the frame, queues it with
+ *        its CRC verdict and re-arms the SPI for the next one.
+ *          Also clears the EXTI pending bit of the select pin.
+ * @return  none
+ */
+void SPISLV_NSSHandler(void) {
+    uint16_t head, length;
+    uint8_t  status, slot;
+
+    EXTI->INTFR = SPISLV_NSSMask;
+    if((SPISLV_NSSGpio->INDR & SPISLV_NSSMask) == 0) {
+        SPI_NSSInternalSoftwareConfig(SPI1, SPI_NSSInternalSoft_Reset);
+        return;
+    }
+    SPI_NSSInternalSoftwareConfig(SPI1, SPI_NSSInternalSoft_Set);
+
+    /* Let DMA take the last byte before reading the ring position */
+    while(SPI1->STATR & SPI_I2S_FLAG_RXNE)
+        ;
+    head = (uint16_t)(SPISLV_RingSize - SPISLV_RX_DMA_Channel->CNTR) & (SPISLV_RingSize - 1);
+    length = (head - SPISLV_Head) & (SPISLV_RingSize - 1);
+    if(length == 0) {
+        SPISLV_Load();
+        return;
+    }
+
+    if(length < 2) {
+        status = SPISLV_Status_CRCError;
+    }
+    else if(SPISLV_TxLength != 0) {
+        status = (SPI1->STATR & SPI_FLAG_CRCERR) ? SPISLV_Status_CRCError : SPISLV_Status_OK;
+    }
+    else {
+        status = (SPI_GetCRC(SPI1, SPI_CRC_Rx) == 0) ? SPISLV_Status_OK : SPISLV_Status_CRCError;
+    }
+    SPISLV_Load();
+
+    slot = SPISLV_FrameIn & (SPISLV_MaxFrames - 1);
+    SPISLV_Total += length;
+    if(((SPISLV_FrameOut != SPISLV_FrameIn) &&
+        (SPISLV_Total - SPISLV_FrameStart[SPISLV_FrameOut & (SPISLV_MaxFrames - 1)] > SPISLV_RingSize)) ||
+       ((uint8_t)(SPISLV_FrameIn - SPISLV_FrameOut) >= SPISLV_MaxFrames)) {
+        SPISLV_Flush = 1;
+        status = SPISLV_Status_Overrun;
+    }
+    else {
+        SPISLV_FrameStart[slot] = SPISLV_Total - length;
+        SPISLV_FrameLength[slot] = (length < 2) ? 0 : (length - 1);
+        SPISLV_FrameStatus[slot] = status;
+        SPISLV_FrameIn++;
+    }
+    SPISLV_Head = head;
+    if(status != SPISLV_Status_OK) {
+        SPISLV_Errors++;
+    }
+
+    if(SPISLV_Callback != 0) {
+        SPISLV_Callback(status);
+    }
+}
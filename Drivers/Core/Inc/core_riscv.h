@@ -33,6 +33,9 @@ extern "C" {
 
 #define __STATIC_FORCEINLINE    __attribute__((always_inline)) static inline
 
+/* Code placed in .highcode runs from RAM, copied there with .data at startup */
+#define __HIGH_CODE             __attribute__((section(".highcode")))
+
 typedef enum {
     NoREADY = 0,
     READY = !NoREADY
@@ -0,0 +1,214 @@
+/*
+ * Host benchmark for the multiply-free filters (ch32v00x_filter).
+ *
+ * Each filter is run next to a conventional fixed-point version whose
+ * multiplies go through soft_mul(), the shift-and-add loop libgcc uses
+ * for __mulsi3 on RV32EC. Host timings are only indicative; the error
+ * columns show what the power-of-two coefficients cost in accuracy.
+ *
+ *     gcc -O2 -IUser/Inc -IDrivers/Core/Inc -IDrivers/CH32V0xx_Driver/Inc \
+ *         Tools/filter_bench.c Drivers/CH32V0xx_Driver/Src/ch32v00x_filter.c \
+ *         -o filter_bench -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ch32v00x_filter.h"
+
+#define SAMPLES 4096
+#define ROUNDS  200
+
+static uint16_t input[SAMPLES];
+static uint16_t out_u[SAMPLES];
+static int16_t  out_s[SAMPLES];
+static int32_t  ref[SAMPLES];
+
+/* __mulsi3 as built for RV32EC: one add per set bit of the multiplier */
+static __attribute__((noinline)) int32_t soft_mul(int32_t a, int32_t b) {
+    uint32_t x = (uint32_t)a, y = (uint32_t)b, r = 0;
+
+    while(x != 0) {
+        if(x & 1) {
+            r += y;
+        }
+        x >>= 1;
+        y <<= 1;
+    }
+    return (int32_t)r;
+}
+
+static double now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, double t_fast, double t_naive, int32_t max_error) {
+    double per = 1e9 / ((double)SAMPLES * ROUNDS);
+
+    printf("%-10s %9.2f %9.2f %8.1fx %10d\n", name, t_fast * per, t_naive * per, t_naive / t_fast, max_error);
+}
+
+/* Moving average: running sum vs a FIR with 1/N taps in Q15 */
+static void bench_ma(void) {
+    FILTER_MATypeDef ma;
+    uint16_t         history[16];
+    int32_t          taps = 32768 / 16, max_error = 0, y;
+    double           t0, t1, t2;
+    int              r, i, k;
+
+    t0 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        FILTER_MAInit(&ma, history, 4);
+        FILTER_MAProcess(&ma, input, SAMPLES, 1, out_u);
+    }
+    t1 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        for(i = 0; i < SAMPLES; i++) {
+            y = 0;
+            for(k = 0; (k < 16) && (k <= i); k++) {
+                y += soft_mul(input[i - k], taps);
+            }
+            ref[i] = y >> 15;
+        }
+    }
+    t2 = now();
+    for(i = 0; i < SAMPLES; i++) {
+        max_error = (abs(out_u[i] - ref[i]) > max_error) ? abs(out_u[i] - ref[i]) : max_error;
+    }
+    report("moving avg", t1 - t0, t2 - t1, max_error);
+}
+
+/* Exponential smoother: 2^-4 by shift vs alpha in Q15 */
+static void bench_ema(void) {
+    FILTER_EMATypeDef ema;
+    int32_t           alpha = 32768 / 16, max_error = 0, acc;
+    double            t0, t1, t2;
+    int               r, i;
+
+    t0 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        FILTER_EMAInit(&ema, 4, input[0]);
+        FILTER_EMAProcess(&ema, input, SAMPLES, 1, out_u);
+    }
+    t1 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        acc = input[0] << 15;
+        for(i = 0; i < SAMPLES; i++) {
+            acc += soft_mul(input[i] - (acc >> 15), alpha);
+            ref[i] = (acc + (1 << 14)) >> 15;
+        }
+    }
+    t2 = now();
+    for(i = 0; i < SAMPLES; i++) {
+        max_error = (abs(out_u[i] - ref[i]) > max_error) ? abs(out_u[i] - ref[i]) : max_error;
+    }
+    report("ema", t1 - t0, t2 - t1, max_error);
+}
+
+/* CIC order 3, rate 8 vs the equivalent 22-tap FIR decimator */
+static void bench_cic(void) {
+    FILTER_CICTypeDef cic;
+    int32_t           taps[22] = {0}, max_error = 0, y;
+    double            t0, t1, t2;
+    int               r, i, k, n = 0, outputs = 0;
+
+    /* Impulse response of three cascaded 8-sample boxcars, gain 512 */
+    for(i = 0; i < 8; i++) {
+        for(k = 0; k < 8; k++) {
+            for(n = 0; n < 8; n++) {
+                taps[i + k + n]++;
+            }
+        }
+    }
+    t0 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        FILTER_CICInit(&cic, 3, 3);
+        outputs = FILTER_CICProcess(&cic, input, SAMPLES, 1, out_u);
+    }
+    t1 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        for(n = 0, i = 7; i < SAMPLES; i += 8, n++) {
+            y = 0;
+            for(k = 0; (k < 22) && (k <= i); k++) {
+                y += soft_mul(input[i - k], taps[k]);
+            }
+            ref[n] = y >> 9;
+        }
+    }
+    t2 = now();
+    for(i = 0; i < outputs; i++) {
+        max_error = (abs(out_u[i] - ref[i]) > max_error) ? abs(out_u[i] - ref[i]) : max_error;
+    }
+    report("cic 3x8", t1 - t0, t2 - t1, max_error);
+}
+
+/* Butterworth low-pass at fs/20: CSD terms vs Q14 multiplies */
+static void bench_biquad(void) {
+    FILTER_BiquadTypeDef bq;
+    double               w = tan(M_PI / 20), n = 1 / (1 + sqrt(2) * w + w * w);
+    double               c[5] = {w * w * n, 2 * w * w * n, w * w * n, 2 * (w * w - 1) * n, (1 - sqrt(2) * w + w * w) * n};
+    int16_t              q[5];
+    int32_t              x1, x2, y1, y2, x, y, max_error = 0;
+    double               t0, t1, t2;
+    int                  r, i;
+
+    for(i = 0; i < 5; i++) {
+        q[i] = (int16_t)lround(c[i] * 16384);
+    }
+    t0 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        FILTER_BiquadInit(&bq, q);
+        FILTER_BiquadProcess(&bq, input, SAMPLES, 1, out_s);
+    }
+    t1 = now();
+    for(r = 0; r < ROUNDS; r++) {
+        x1 = x2 = y1 = y2 = 0;
+        for(i = 0; i < SAMPLES; i++) {
+            /* Q4 state: Q14 products of Q8 samples would overflow 32 bits */
+            x = input[i] << 4;
+            y = (soft_mul(q[0], x) + soft_mul(q[1], x1) + soft_mul(q[2], x2) - soft_mul(q[3], y1) -
+                 soft_mul(q[4], y2)) >> 14;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            ref[i] = (y + 8) >> 4;
+        }
+    }
+    t2 = now();
+    for(i = 0; i < SAMPLES; i++) {
+        max_error = (abs(out_s[i] - ref[i]) > max_error) ? abs(out_s[i] - ref[i]) : max_error;
+    }
+    report("biquad", t1 - t0, t2 - t1, max_error);
+
+    printf("\nbiquad coefficients, Q14 -> %d power-of-two terms:\n", FILTER_CSDTerms);
+    for(i = 0; i < 3; i++) {
+        printf("  b%d %6d -> %6d\n", i, q[i], FILTER_CSDValue(&bq.FILTER_B[i]));
+    }
+    for(i = 0; i < 2; i++) {
+        printf("  a%d %6d -> %6d\n", i + 1, q[3 + i], FILTER_CSDValue(&bq.FILTER_A[i]));
+    }
+}
+
+int main(void) {
+    int i;
+
+    /* 10-bit ADC-like signal: slow sine, a faster tone and noise */
+    srand(1);
+    for(i = 0; i < SAMPLES; i++) {
+        input[i] = (uint16_t)(512 + 300 * sin(i * 0.01) + 60 * sin(i * 0.9) + (rand() % 32) - 16);
+    }
+
+    printf("%-10s %9s %9s %9s %10s\n", "filter", "ns/sample", "naive", "speedup", "max error");
+    bench_ma();
+    bench_ema();
+    bench_cic();
+    bench_biquad();
+
+    return 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * Host test for back-to-back I2CQ jobs on the I2CM engine.
+ *
+ * I2CQ_Done() submits the next job from inside the I2CM completion, while
+ * the STOP of the finished job is still pending and its TXE or BTF flag is
+ * still set. A handler that acts on those stale flags writes the first
+ * byte of the next job before its START, or reads before its address
+ * phase. This test chains a 2-byte write to a 1-byte write plus a read of
+ * 1, 2 and 3 bytes, and checks the bytes seen on a modelled bus.
+ *
+ * The drivers are compiled as C++ so that I2C1 can be replaced by a model
+ * whose registers intercept reads and writes, like the real peripheral
+ * (SB, ADDR and BTF cleared by a status read followed by a data or STAR2
+ * access). Only the interrupt-driven path is exercised: transfers stay
+ * below I2CM_DMAThreshold. -fpermissive allows the drivers' pointer to
+ * uint32_t casts on a 64-bit host.
+ *
+ *     g++ -fpermissive -w -IUser/Inc -IDrivers/Core/Inc \
+ *         -IDrivers/CH32V0xx_Driver/Inc Tools/i2cq_chain_test.cpp \
+ *         -o i2cq_chain_test
+ *
+ * Exits with 0 when every case passes.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep the RISC-V CSR accessors out of the way; the host has none */
+#define I2C_TypeDef   HW_I2C_TypeDef
+#define __get_MSTATUS HW_get_MSTATUS
+#define __set_MSTATUS HW_set_MSTATUS
+#define __disable_irq HW_disable_irq
+#define __enable_irq  HW_enable_irq
+#include "ch32v00x.h"
+#include "ch32v00x_dma.h"
+#include "ch32v00x_gpio.h"
+#include "ch32v00x_i2c.h"
+#include "ch32v00x_rcc.h"
+#undef __get_MSTATUS
+#undef __set_MSTATUS
+#undef __disable_irq
+#undef __enable_irq
+
+static uint32_t __get_MSTATUS(void) {
+    return 0;
+}
+
+static void __set_MSTATUS(uint32_t) {
+}
+
+static void __disable_irq(void) {
+}
+
+/* Register that forwards every access to the bus model */
+struct Reg;
+static uint16_t model_read(Reg *r);
+static void     model_write(Reg *r, uint16_t v);
+
+struct Reg {
+    uint16_t v;
+    operator uint16_t() {
+        return model_read(this);
+    }
+    Reg &operator=(uint16_t x) {
+        model_write(this, x);
+        return *this;
+    }
+    Reg &operator|=(uint16_t x) {
+        model_write(this, (uint16_t)(v | x));
+        return *this;
+    }
+    Reg &operator&=(uint16_t x) {
+        model_write(this, (uint16_t)(v & x));
+        return *this;
+    }
+};
+
+static uint16_t model_star2(void);
+
+struct ModelI2C {
+    Reg      CTLR1, CTLR2, OADDR1, OADDR2, DATAR, STAR1, CKCFGR;
+    uint16_t star2() {
+        return model_star2();
+    }
+};
+
+static ModelI2C            model_i2c;
+static DMA_Channel_TypeDef model_dma6, model_dma7;
+static DMA_TypeDef         model_dma;
+
+#undef I2C1
+#undef DMA1
+#undef DMA1_Channel6
+#undef DMA1_Channel7
+#define I2C1          (&model_i2c)
+#define DMA1          (&model_dma)
+#define DMA1_Channel6 (&model_dma6)
+#define DMA1_Channel7 (&model_dma7)
+#define STAR2         star2()
+
+/* Peripheral library calls the drivers make, reduced to what the model needs */
+void I2C_TransmitPEC(ModelI2C *, FunctionalState) {
+}
+
+void I2C_CalculatePEC(ModelI2C *, FunctionalState) {
+}
+
+void I2C_DMALastTransferCmd(ModelI2C *, FunctionalState) {
+}
+
+void I2C_DMACmd(ModelI2C *, FunctionalState) {
+}
+
+void I2C_ClockUpdate(ModelI2C *) {
+}
+
+void I2C_SoftwareResetCmd(ModelI2C *, FunctionalState) {
+}
+
+void I2C_ITConfig(ModelI2C *I2Cx, uint16_t I2C_IT, FunctionalState NewState) {
+    if(NewState != DISABLE) {
+        I2Cx->CTLR2.v |= I2C_IT;
+    }
+    else {
+        I2Cx->CTLR2.v &= (uint16_t)~I2C_IT;
+    }
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef *) {
+}
+
+void DMA_Init(DMA_Channel_TypeDef *, DMA_InitTypeDef *) {
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef *, uint32_t, FunctionalState) {
+}
+
+void GPIO_Init(GPIO_TypeDef *, GPIO_InitTypeDef *) {
+}
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef *RCC_Clocks) {
+    RCC_Clocks->HCLK_Frequency = 48000000;
+}
+
+#include "../Drivers/CH32V0xx_Driver/Src/ch32v00x_i2cm.c"
+#include "../Drivers/CH32V0xx_Driver/Src/ch32v00x_i2cq.c"
+
+/* Bus model: one master, one slave at 0x50 returning 0xA0, 0xA1, ... */
+#define SLAVE_ADDRESS 0x50
+
+enum { BUS_IDLE, BUS_SB, BUS_ADDRESS, BUS_ADDR_WAIT, BUS_TX, BUS_RX };
+
+static int      bus = BUS_IDLE;
+static int      transmitter, status_read, data_full, shift_full, last_nacked, pos_nack, rx_index;
+static uint16_t data, shift, address_byte;
+static int      errors;
+static uint8_t  slave_rx[64];
+static int      slave_rx_length;
+static uint8_t  slave_next;
+
+#define SR1 model_i2c.STAR1.v
+#define CR1 model_i2c.CTLR1.v
+
+static uint16_t model_read(Reg *r) {
+    uint16_t value;
+
+    if(r == &model_i2c.STAR1) {
+        status_read = 1;
+    }
+    else if(r == &model_i2c.DATAR) {
+        value = data;
+        if((bus != BUS_RX) || !(SR1 & I2C_STAR1_RXNE)) {
+            printf("  DATAR read with RXNE clear\n");
+            errors++;
+        }
+        if(status_read) {
+            SR1 &= (uint16_t)~I2C_STAR1_BTF;
+        }
+        if(shift_full) {
+            data = shift;
+            shift_full = 0;
+            SR1 |= I2C_STAR1_RXNE;
+        }
+        else {
+            SR1 &= (uint16_t)~I2C_STAR1_RXNE;
+        }
+        return value;
+    }
+    return r->v;
+}
+
+static void model_write(Reg *r, uint16_t v) {
+    if(r == &model_i2c.DATAR) {
+        if((SR1 & I2C_STAR1_SB) && status_read) {
+            SR1 &= (uint16_t)~I2C_STAR1_SB;
+            address_byte = v;
+            bus = BUS_ADDRESS;
+            return;
+        }
+        /* A byte written while START or STOP is pending belongs to no transfer */
+        if((bus != BUS_TX) || data_full || (CR1 & (I2C_CTLR1_STOP | I2C_CTLR1_START))) {
+            printf("  DATAR write 0x%02X outside a transmit phase\n", v);
+            errors++;
+            return;
+        }
+        if(status_read) {
+            SR1 &= (uint16_t)~I2C_STAR1_BTF;
+        }
+        data = v;
+        data_full = 1;
+        SR1 &= (uint16_t)~I2C_STAR1_TXE;
+        return;
+    }
+    if(r == &model_i2c.STAR1) {
+        r->v &= v;
+        return;
+    }
+    r->v = v;
+}
+
+static uint16_t model_star2(void) {
+    if((SR1 & I2C_STAR1_ADDR) && status_read) {
+        SR1 &= (uint16_t)~I2C_STAR1_ADDR;
+        if(transmitter) {
+            bus = BUS_TX;
+            SR1 |= I2C_STAR1_TXE;
+        }
+        else {
+            bus = BUS_RX;
+            rx_index = 0;
+            last_nacked = 0;
+            pos_nack = (CR1 & I2C_CTLR1_POS) && !(CR1 & I2C_CTLR1_ACK);
+        }
+    }
+    return (uint16_t)((transmitter ? 0x04 : 0) | 0x03);
+}
+
+/* Advances the bus by one byte time; STOP is acted on before START */
+static void model_step(void) {
+    int tx_quiet = (bus == BUS_TX) && !shift_full && !data_full;
+    int rx_quiet = (bus == BUS_RX) && last_nacked;
+    int ack;
+
+    if((CR1 & I2C_CTLR1_STOP) && (tx_quiet || rx_quiet)) {
+        CR1 &= (uint16_t)~I2C_CTLR1_STOP;
+        SR1 &= (uint16_t)~(I2C_STAR1_BTF | I2C_STAR1_TXE | I2C_STAR1_RXNE);
+        bus = BUS_IDLE;
+        transmitter = 0;
+        return;
+    }
+    if((CR1 & I2C_CTLR1_START) && ((bus == BUS_IDLE) || tx_quiet || rx_quiet)) {
+        CR1 &= (uint16_t)~I2C_CTLR1_START;
+        SR1 &= (uint16_t)~(I2C_STAR1_BTF | I2C_STAR1_TXE);
+        SR1 |= I2C_STAR1_SB;
+        status_read = 0;
+        bus = BUS_SB;
+        return;
+    }
+    switch(bus) {
+        case BUS_ADDRESS:
+            if((address_byte >> 1) != SLAVE_ADDRESS) {
+                printf("  address byte 0x%02X\n", address_byte);
+                errors++;
+            }
+            transmitter = !(address_byte & 0x01);
+            status_read = 0;
+            SR1 |= I2C_STAR1_ADDR;
+            bus = BUS_ADDR_WAIT;
+            break;
+
+        case BUS_TX:
+            if(shift_full) {
+                slave_rx[slave_rx_length++] = (uint8_t)shift;
+                shift_full = 0;
+                if(!data_full) {
+                    SR1 |= I2C_STAR1_BTF;
+                    status_read = 0;
+                }
+            }
+            if(data_full && !shift_full) {
+                shift = data;
+                shift_full = 1;
+                data_full = 0;
+                SR1 |= I2C_STAR1_TXE;
+            }
+            break;
+
+        case BUS_RX:
+            if(last_nacked || ((SR1 & I2C_STAR1_RXNE) && shift_full)) {
+                break;
+            }
+            ack = pos_nack ? (rx_index == 0) : ((CR1 & I2C_CTLR1_ACK) != 0);
+            rx_index++;
+            if(!(SR1 & I2C_STAR1_RXNE)) {
+                data = slave_next++;
+                SR1 |= I2C_STAR1_RXNE;
+            }
+            else {
+                shift = slave_next++;
+                shift_full = 1;
+                SR1 |= I2C_STAR1_BTF;
+                status_read = 0;
+            }
+            if(!ack || (CR1 & I2C_CTLR1_STOP)) {
+                last_nacked = 1;
+            }
+            break;
+    }
+}
+
+static int model_event_pending(void) {
+    uint16_t ctlr2 = model_i2c.CTLR2.v;
+
+    if(!(ctlr2 & I2C_CTLR2_ITEVTEN)) {
+        return 0;
+    }
+    if(SR1 & (I2C_STAR1_SB | I2C_STAR1_ADDR | I2C_STAR1_BTF)) {
+        return 1;
+    }
+    return (ctlr2 & I2C_CTLR2_ITBUFEN) && (SR1 & (I2C_STAR1_TXE | I2C_STAR1_RXNE));
+}
+
+static I2CQ_JobTypeDef job1, job2;
+static uint8_t         write1[2] = {0x10, 0x55}, write2[1] = {0x20}, read2[4];
+static int             completed;
+
+static void job_done(I2CQ_JobTypeDef *) {
+    completed++;
+}
+
+/* Runs the bus until both jobs are reported, then lets it settle */
+static void run(void) {
+    int step, k;
+
+    for(step = 0; (step < 2000) && (completed < 2); step++) {
+        for(k = 0; (k < 3) && model_event_pending(); k++) {
+            I2CM_EV_IRQHandler();
+        }
+        model_step();
+    }
+    for(step = 0; step < 20; step++) {
+        for(k = 0; (k < 3) && model_event_pending(); k++) {
+            I2CM_EV_IRQHandler();
+        }
+        model_step();
+    }
+}
+
+static int chain(uint16_t rx_length) {
+    int ok, i;
+
+    errors = 0;
+    completed = 0;
+    slave_rx_length = 0;
+    slave_next = 0xA0;
+    memset(read2, 0, sizeof(read2));
+    memset(&job1, 0, sizeof(job1));
+    memset(&job2, 0, sizeof(job2));
+
+    job1.I2CQ_Transfer.I2CM_Address = SLAVE_ADDRESS;
+    job1.I2CQ_Transfer.I2CM_TxData = write1;
+    job1.I2CQ_Transfer.I2CM_TxLength = sizeof(write1);
+    job1.I2CQ_Callback = job_done;
+    job1.I2CQ_Priority = 0;
+    job2.I2CQ_Transfer.I2CM_Address = SLAVE_ADDRESS;
+    job2.I2CQ_Transfer.I2CM_TxData = write2;
+    job2.I2CQ_Transfer.I2CM_TxLength = sizeof(write2);
+    job2.I2CQ_Transfer.I2CM_RxData = read2;
+    job2.I2CQ_Transfer.I2CM_RxLength = rx_length;
+    job2.I2CQ_Callback = job_done;
+    job2.I2CQ_Priority = 1;
+    I2CQ_Add(&job1);
+    I2CQ_Add(&job2);
+    run();
+
+    ok = (errors == 0) && (completed == 2) && (bus == BUS_IDLE) &&
+         (job1.I2CQ_Transfer.I2CM_Status == I2CM_Status_Done) &&
+         (job2.I2CQ_Transfer.I2CM_Status == I2CM_Status_Done) && (slave_rx_length == 3) &&
+         (slave_rx[0] == 0x10) && (slave_rx[1] == 0x55) && (slave_rx[2] == 0x20);
+    for(i = 0; i < rx_length; i++) {
+        ok = ok && (read2[i] == 0xA0 + i);
+    }
+    printf("write 2, then write 1 + read %u: %s\n", rx_length, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+int main(void) {
+    int ok = 1;
+
+    I2CM_Init();
+    I2CQ_Init();
+    ok &= chain(1);
+    ok &= chain(2);
+    ok &= chain(3);
+
+    return ok ? 0 : 1;
+}
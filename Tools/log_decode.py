@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Decoder for the deferred-format log stream (ch32v00x_log).
+
+The target only sends a format id (offset into the non-loaded .log_fmt
+section) and raw 32-bit argument words. This tool takes the format strings
+from the ELF file and prints the formatted messages.
+
+    log_decode.py [--elf Build/CH32V003.elf] [--baud 115200] [input]
+
+input is a capture file, a serial port (needs pyserial) or '-' for stdin.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+HEADER_SYNC = 0xA5
+SECTION = ".log_fmt"
+
+SPEC = re.compile(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(?:hh|h|ll|l|z|t|j)?([diouxXcps%])")
+
+
+def load_formats(path):
+    """Returns the raw contents of the .log_fmt section."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        sys.exit("%s: not an ELF file" % path)
+    is64 = elf[4] == 2
+    if is64:
+        shoff, = struct.unpack_from("<Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x3A)
+    else:
+        shoff, = struct.unpack_from("<I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def section(index):
+        base = shoff + index * shentsize
+        if is64:
+            name, _, _, _, offset, size = struct.unpack_from("<IIQQQQ", elf, base)
+        else:
+            name, _, _, _, offset, size = struct.unpack_from("<IIIIII", elf, base)
+        return name, offset, size
+
+    _, stroff, _ = section(shstrndx)
+    for i in range(shnum):
+        name, offset, size = section(i)
+        end = elf.index(b"\0", stroff + name)
+        if elf[stroff + name:end].decode() == SECTION:
+            return elf[offset:offset + size]
+    sys.exit("%s: no %s section, was anything logged?" % (path, SECTION))
+
+
+def format_message(fmt, args):
+    args = list(args)
+
+    def convert(m):
+        flags, width, prec, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if not args:
+            return "<?>"
+        value = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if conv in "di":
+            return (spec + "d") % (value - (1 << 32) if value & 0x80000000 else value)
+        if conv == "u":
+            return (spec + "d") % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        if conv == "s":
+            return "<str@0x%08x>" % value
+        return (spec + conv) % value
+
+    return SPEC.sub(convert, fmt)
+
+
+def chunks(stream):
+    """Yields whatever is available without waiting for a full block."""
+    while True:
+        if hasattr(stream, "in_waiting"):
+            data = stream.read(stream.in_waiting or 1)
+        elif hasattr(stream, "read1"):
+            data = stream.read1(256)
+        else:
+            data = stream.read(256)
+        if not data:
+            return
+        yield data
+
+
+def records(stream):
+    """Yields (header, args), resynchronising byte by byte on the sync byte."""
+    buf = bytearray()
+    for data in chunks(stream):
+        buf += data
+        while len(buf) >= 4:
+            if buf[3] != HEADER_SYNC:
+                del buf[0]
+                continue
+            header, = struct.unpack_from("<I", buf)
+            need = 4 + 4 * ((header >> 16) & 0x0F)
+            if len(buf) < need:
+                break
+            args = struct.unpack_from("<%dI" % ((need - 4) // 4), buf, 4)
+            del buf[:need]
+            yield header, args
+
+
+def decode(stream, formats, out):
+    seq = None
+    for header, args in records(stream):
+        fmt_id = header & 0xFFFF
+        this_seq = (header >> 20) & 0x0F
+        if seq is not None and this_seq != (seq + 1) & 0x0F:
+            out.write("[%d record(s) lost]\n" % ((this_seq - seq - 1) & 0x0F))
+        seq = this_seq
+        if fmt_id >= len(formats):
+            out.write("[unknown format id 0x%04x]\n" % fmt_id)
+            continue
+        end = formats.find(b"\0", fmt_id)
+        fmt = formats[fmt_id:end].decode(errors="replace")
+        out.write(format_message(fmt, args) + "\n")
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--elf", default="Build/CH32V003.elf", help="firmware ELF file")
+    parser.add_argument("--baud", type=int, default=115200, help="serial port baud rate")
+    parser.add_argument("input", nargs="?", default="-", help="capture file, serial port or '-'")
+    opts = parser.parse_args()
+
+    formats = load_formats(opts.elf)
+    if opts.input == "-":
+        stream = sys.stdin.buffer
+    elif opts.input.startswith(("/dev/tty", "COM")):
+        import serial
+        stream = serial.Serial(opts.input, opts.baud, timeout=None)
+    else:
+        stream = open(opts.input, "rb")
+    try:
+        decode(stream, formats, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
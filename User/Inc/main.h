@@ -3,18 +3,39 @@
 #define __MAIN_H
 
 #include "ch32v00x_adc.h"
+#include "ch32v00x_adcinj.h"
+#include "ch32v00x_adcmon.h"
+#include "ch32v00x_adcovs.h"
+#include "ch32v00x_adcscan.h"
 #include "ch32v00x_dbgmcu.h"
 #include "ch32v00x_dma.h"
+#include "ch32v00x_ds18b20.h"
 #include "ch32v00x_exti.h"
+#include "ch32v00x_filter.h"
 #include "ch32v00x_flash.h"
+#include "ch32v00x_frame.h"
+#include "ch32v00x_gfx.h"
 #include "ch32v00x_gpio.h"
 #include "ch32v00x_i2c.h"
+#include "ch32v00x_i2cm.h"
+#include "ch32v00x_i2cq.h"
+#include "ch32v00x_i2cslv.h"
+#include "ch32v00x_iap.h"
 #include "ch32v00x_it.h"
 #include "ch32v00x_iwdg.h"
+#include "ch32v00x_lin.h"
+#include "ch32v00x_log.h"
+#include "ch32v00x_mdbus.h"
 #include "ch32v00x_misc.h"
+#include "ch32v00x_modbus.h"
+#include "ch32v00x_onewire.h"
 #include "ch32v00x_pwr.h"
 #include "ch32v00x_rcc.h"
+#include "ch32v00x_smbus.h"
 #include "ch32v00x_spi.h"
+#include "ch32v00x_spibus.h"
+#include "ch32v00x_spinor.h"
+#include "ch32v00x_spislv.h"
 #include "ch32v00x_tim.h"
 #include "ch32v00x_usart.h"
 #include "ch32v00x_wwdg.h"